@@ -15,7 +15,7 @@ extern "C" {
 /** コマンド状態を初期化し、RX サブスクリプションを CyphalTransport に登録する。 */
 void actuator_command_init(void);
 
-/** 現在のコマンド状態をアクチュエータに適用する。タスクループから周期的に呼ぶ。 */
+/** 現在のコマンド状態をアクチュエータに適用する。ActuatorTask から PWM 周期ごとに呼ぶ。 */
 void actuator_command_apply(void);
 
 /** デコードエラー・タイムアウト回数を取得する。 */
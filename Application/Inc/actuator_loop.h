@@ -0,0 +1,44 @@
+/**
+ * @file actuator_loop.h
+ * @brief サーボ PWM 周期（TIM2 更新イベント, 50 Hz）に同期したアクチュエータ更新。
+ *
+ * TIM2 の更新割り込みで ActuatorTask を起こし、actuator_command_apply() を 1 周期に 1 回だけ呼ぶ。
+ * CCR はプリロード有効なので、周期 n で書いた値は周期 n+1 の先頭で一斉に反映される
+ * （RX の到着タイミングに関係なく遅れは 1 周期で一定）。
+ * CyphalControlTask より高い優先度で動かし、通信処理と互いに干渉しないようにする。
+ */
+
+#ifndef ACTUATOR_LOOP_H
+#define ACTUATOR_LOOP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** 更新周期 [µs]（TIM2: PSC=159, ARR=19999）。 */
+#define ACTUATOR_LOOP_PERIOD_USEC  20000U
+
+typedef struct {
+    uint32_t periods;           /* 適用した回数 */
+    uint32_t overruns;          /* 前回の適用が終わる前に次の更新イベントが来た回数 */
+    uint32_t timeouts;          /* 更新イベントが来ず、タイムアウトで適用した回数 */
+    uint32_t max_latency_usec;  /* 更新イベント → 適用開始 の最大値 */
+    uint32_t max_jitter_usec;   /* 適用開始間隔と ACTUATOR_LOOP_PERIOD_USEC の差の最大値 */
+} ActuatorLoopStats;
+
+/** FreeRTOS タスクエントリ。actuator_command_init() の後に xTaskCreate する。 */
+void ActuatorTask(void* pvParameters);
+
+/** TIM2 更新割り込み (HAL_TIM_PeriodElapsedCallback) から呼ぶ。 */
+void actuator_loop_isr_period(void);
+
+/** 統計のスナップショット（ActuatorTask が更新中なら 1 周期分ずれることがある）。 */
+void actuator_loop_get_stats(ActuatorLoopStats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ACTUATOR_LOOP_H */
@@ -9,15 +9,34 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/* 1: servo compares are written to a RAM image that the TIM2 update DMA burst (DCR/DMAR) loads
+ *    into CCR1..CCR4 on every update event, so all four change in the same PWM period.
+ * 0: write CCR1..CCR4 directly (preloaded; an update between the writes splits them). */
+#ifndef ACTUATOR_OUTPUT_DMA_BURST
+#define ACTUATOR_OUTPUT_DMA_BURST 1
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Per-servo pulse calibration [us]. Setpoint -1 / 0 / +1 maps to min / neutral / max (swapped if reversed). */
+typedef struct {
+    uint16_t min_us;
+    uint16_t neutral_us;
+    uint16_t max_us;
+    bool     reversed;
+} ServoCalibration;
+
 /** Servo setpoints: rad or rad/s; applied as -1..1 to pulse width. Pump: on/off. Readiness: 0/2/3. */
 void actuator_output_apply(const float servo_setpoints[4], bool pump_on, uint8_t readiness);
 
+/** Starts the PWM outputs with the default calibration (900 / 1500 / 2100 us on every servo). */
 void actuator_output_init(void);
 
+/** Replaces the calibration of one servo (0..3); takes effect on the next apply. Call from the apply context. */
+void actuator_output_set_calibration(uint8_t channel, const ServoCalibration* cal);
+
 #ifdef __cplusplus
 }
 #endif
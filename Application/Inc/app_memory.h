@@ -1,6 +1,10 @@
 /**
  * @file app_memory.h
- * @brief FreeRTOS heap_4 wrappers for libcanard (allocate/deallocate).
+ * @brief libcanard memory resource: fixed-block pools (default) or FreeRTOS heap_4 wrappers.
+ *
+ * Select the backend with APP_MEMORY_BACKEND (compile definition). The pool backend is
+ * O(1), never fragments and does not take the scheduler lock. It is not thread-safe:
+ * libcanard must only be used from CyphalControlTask.
  */
 
 #ifndef APP_MEMORY_H
@@ -11,12 +15,53 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
+
+#define APP_MEMORY_BACKEND_POOL   0
+#define APP_MEMORY_BACKEND_HEAP4  1
+
+#ifndef APP_MEMORY_BACKEND
+#define APP_MEMORY_BACKEND APP_MEMORY_BACKEND_POOL
+#endif
+
+/* Largest subscription extent the pool backend can reassemble. libcanard allocates the whole
+ * extent for every multi-frame transfer, so CyphalTransport::subscribe() rejects larger ones. */
+#ifndef APP_MEMORY_REASSEMBLY_SIZE
+#define APP_MEMORY_REASSEMBLY_SIZE  256U
+#endif
+
+/** Pool size classes. */
+enum AppMemoryPoolClass {
+    APP_MEMORY_POOL_SESSION = 0,  /* RX sessions, small RX payloads */
+    APP_MEMORY_POOL_TX_ITEM,      /* CanardTxQueueItem (bench frame streams only) */
+    APP_MEMORY_POOL_PAYLOAD,      /* MTU-sized (64 B) TX frame / RX transfer payloads */
+    APP_MEMORY_POOL_REASSEMBLY,   /* multi-frame RX reassembly buffers (subscription extent) */
+    APP_MEMORY_POOL_CLASS_COUNT
+};
+
+typedef struct {
+    size_t   block_size;
+    uint16_t block_count;
+    uint16_t in_use;
+    uint16_t peak_in_use;
+    uint32_t alloc_failures;  /* class was the best fit but it and all larger classes were full */
+} AppMemoryPoolStats;
+
+typedef struct {
+    uint32_t allocations;     /* successful allocate() calls, any backend */
+    uint32_t deallocations;
+    uint32_t failures;        /* allocate() returned NULL */
+    AppMemoryPoolStats pools[APP_MEMORY_POOL_CLASS_COUNT];  /* zero with the heap_4 backend */
+} AppMemoryStats;
 
 struct CanardMemoryResource;
 
-/** libcanard v4 memory resource (allocate + deallocate, backed by heap_4). */
+/** libcanard v4 memory resource (allocate + deallocate) for the selected backend. */
 struct CanardMemoryResource app_memory_canard_resource(void);
 
+/** Snapshot of the allocation counters. */
+void app_memory_get_stats(AppMemoryStats* out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,102 @@
+/**
+ * @file cycle_profiler.h
+ * @brief DWT CYCCNT による区間計測（min / max / mean サイクル）。
+ *
+ * USAGI_PROFILE=0（Release ビルド）ではマクロごと消えるので、計測点を残したままでよい。
+ *   C:   PROF_BEGIN(t); ...; PROF_END(PROF_ACTUATOR_APPLY, t);
+ *   C++: PROF_SCOPE(PROF_PROCESS_RX);
+ * 各区間は 1 つのコンテキスト（ISR かタスクのどちらか）からだけ計測すること。
+ * 集計値は CyphalControlTask が uavcan.primitive.array.Natural32 で定期送信する（cyphal_node.cpp）。
+ */
+
+#ifndef CYCLE_PROFILER_H
+#define CYCLE_PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#ifndef USAGI_PROFILE
+#define USAGI_PROFILE 0
+#endif
+
+/** 計測区間。RX ハンドラは CyphalTransport のサブスクリプション番号ごと。 */
+typedef enum {
+    PROF_ISR_RX = 0,
+    PROF_PROCESS_RX,
+    PROF_FLUSH_TX,
+    PROF_ACTUATOR_APPLY,
+    PROF_PUBLISH_SERIALIZE,
+    PROF_RX_READ,          /* isr_rx: RX FIFO0 の 1 要素 → リングのスロット */
+    PROF_TX_WRITE,         /* flush_tx: 1 フレーム → TX FIFO/キューの要素 */
+    PROF_RX_HANDLER_0,
+    PROF_RX_HANDLER_LAST = PROF_RX_HANDLER_0 + 7,  /* CyphalTransport::kMaxSubscriptions - 1 */
+    PROF_REGION_COUNT
+} ProfRegion;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_cycles;   /* count == 0 のときは 0 */
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+} ProfStats;
+
+#if USAGI_PROFILE
+
+#include "main.h"
+
+/** DWT CYCCNT を有効化し、集計をクリアする。 */
+void prof_init(void);
+
+/** 区間 region の 1 回分を記録する。start は PROF_BEGIN で取った CYCCNT。 */
+void prof_record(ProfRegion region, uint32_t start);
+
+/** 集計のスナップショット（他コンテキストが更新中の区間は 1 回分ずれることがある）。 */
+void prof_get(ProfRegion region, ProfStats* out);
+
+#define PROF_BEGIN(var)         const uint32_t var = DWT->CYCCNT
+#define PROF_END(region, var)   prof_record((region), (var))
+
+#else
+
+static inline void prof_init(void) {}
+static inline void prof_get(ProfRegion region, ProfStats* out)
+{
+    (void)region;
+    out->count = 0; out->min_cycles = 0; out->max_cycles = 0; out->total_cycles = 0;
+}
+
+#define PROF_BEGIN(var)         ((void)0)
+#define PROF_END(region, var)   ((void)0)
+
+#endif /* USAGI_PROFILE */
+
+#ifdef __cplusplus
+}
+
+#if USAGI_PROFILE
+/** スコープの出口で prof_record する。 */
+class ProfScope {
+public:
+    explicit ProfScope(ProfRegion region) : region_(region), start_(DWT->CYCCNT) {}
+    ~ProfScope() { prof_record(region_, start_); }
+    ProfScope(const ProfScope&) = delete;
+    ProfScope& operator=(const ProfScope&) = delete;
+
+private:
+    ProfRegion region_;
+    uint32_t   start_;
+};
+
+#define PROF_CONCAT_(a, b)  a##b
+#define PROF_CONCAT(a, b)   PROF_CONCAT_(a, b)
+#define PROF_SCOPE(region)  ProfScope PROF_CONCAT(prof_scope_, __LINE__)(region)
+#else
+#define PROF_SCOPE(region)  ((void)0)
+#endif
+
+#endif /* __cplusplus */
+
+#endif /* CYCLE_PROFILER_H */
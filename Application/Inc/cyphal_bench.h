@@ -0,0 +1,78 @@
+/**
+ * @file cyphal_bench.h
+ * @brief Cyphal RX/TX 経路のベンチマーク（ホスト / 実機共通）。
+ *
+ * CyphalControlTask の代わりに CyphalBenchTask を起動すると、
+ * - RX: 合成（ホストでは記録も）CAN FD フレーム列を process_rx → canardRxAccept に流す
+ * - TX: 型付きメッセージを cyphal::publish → flush_tx で FDCAN に積む
+ * を繰り返し、シナリオごとに 1 行の JSON を stdout（実機では COM1）に出して終了する。
+ * 計時は DWT CYCCNT（ホストでは 1 count = 1 ns）。
+ *
+ * 出力例:
+ *   {"bench":"rx_single","platform":"host","transfers":2000,"frames":2000,
+ *    "ns_per_frame":850,"frames_per_sec":1176470,"allocs_per_transfer":0.000,"max_latency_ns":9120}
+ * allocs_per_transfer は app_memory の確保回数。rx_single / rx_single_burst16 は単一フレーム経路
+ * （CYPHAL_RX_SINGLE_FRAME_BYPASS）なので 0、rx_multi は canard の再組み立て分だけ確保する。
+ * tx_* は TX キューのアリーナへ直接シリアライズするので 0。
+ * tx_framing は TxTransferQueue と canardTxPush のフレームを比べた不一致数（mismatches）を出す。0 以外は不具合。
+ */
+
+#ifndef CYPHAL_BENCH_H
+#define CYPHAL_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** 記録済みストリームの 1 フレーム（拡張 ID、データ長はバイト数）。 */
+typedef struct {
+    uint32_t can_id;
+    uint8_t  size;
+    uint8_t  data[64];
+} CyphalBenchFrame;
+
+/** 記録済みストリームを登録する（rx_replay シナリオ）。タスク起動前に呼ぶ。 */
+void cyphal_bench_set_recording(const CyphalBenchFrame* frames, size_t count);
+
+/** FreeRTOS タスクエントリ。cyphal_node_init() の後に xTaskCreate する。 */
+void CyphalBenchTask(void* pvParameters);
+
+/* ---- プラットフォーム依存部（実機: cyphal_bench_port.c / ホスト: Host/Src/host_bench_port.c） ---- */
+
+/** 出力の "platform" フィールド。 */
+const char* cyphal_bench_platform(void);
+
+/** DWT CYCCNT の周波数 [count/s]。 */
+uint32_t cyphal_bench_cycles_per_sec(void);
+
+/** TX シナリオの前（start_fdcan() の前）に呼ぶ。実機では FDCAN を内部ループバックにする。 */
+void cyphal_bench_prepare_bus(void);
+
+/** HW TX FIFO が空なら true。ホストではここでフレームをバスに送出する。 */
+bool cyphal_bench_service_tx(void);
+
+/**
+ * 送信待ちの HW TX バッファから調停に勝つ 1 フレームをバスに出し、その内容を返す（tx_priority 用）。
+ * 送信待ちがなければ false。実機ではコントローラが自分で送出するので常に false。
+ */
+bool cyphal_bench_bus_transmit(CyphalBenchFrame* out);
+
+/**
+ * 1 フレームをバスから受信させる（FDCAN の RX FIFO0 → isr_rx を通す RX シナリオ用）。start_fdcan() の後に呼ぶ。
+ * ホストは RX FIFO0 に入れば true（フィルタで落ちれば false）。実機は内部ループバックで送信し、
+ * 送信が終われば true（受信側のフィルタの結果は分からない）。
+ */
+bool cyphal_bench_bus_receive(const CyphalBenchFrame* frame);
+
+/** 全シナリオ終了時に呼ぶ。戻らない。 */
+void cyphal_bench_finish(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CYPHAL_BENCH_H */
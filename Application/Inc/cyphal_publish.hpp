@@ -4,8 +4,11 @@
  *
  * 責務の分離:
  * - 型依存: 各 DSDL 型の serialize 呼び出し・バッファサイズ（nunavut C++ 生成に委譲）。
- * - 型非依存: CyphalTransport::push(subject_id, tid, payload, size) による
- *   TX キュー投入・メタデータ構築・送信境界（transport 層が担当）。
+ * - 型非依存: CyphalTransport::tx_reserve / tx_commit による
+ *   TX キュー投入・メタデータ構築・フレーム分割（transport 層が担当）。
+ *
+ * シリアライズ先は TX キューのアリーナ内の予約領域なので、スタックに最大長のバッファを取らず、
+ * ペイロードのコピーも flush 時に HW へ積む 1 回だけになる。
  *
  * 使い方:
  *   #include <uavcan/node/Heartbeat_1_0.hpp>
@@ -13,31 +16,51 @@
  *   hb.uptime = ...;
  *   static CanardTransferID tid{0};
  *   cyphal::publish::publish(uavcan::node::Heartbeat_1_0::_traits_::FixedPortId, tid, hb);
+ *
+ * 優先度・期限は subject ごとの既定値（CyphalTransport::set_tx_options）を使う。
+ * 1 回だけ変えたいときは TxOptions を明示する:
+ *   cyphal::publish(subject_id, tid, msg, {CanardPriorityFast, 5000U});
  */
 
 #pragma once
 
 #include "canard.h"
 #include "cyphal_transport.hpp"
+#include "cycle_profiler.h"
 #include "nunavut/support/serialization.hpp"
 #include <cstddef>
 
 namespace cyphal {
 
 /**
- * nunavut C++ で生成された型をシリアライズして送信する。
+ * nunavut C++ で生成された型をシリアライズし、指定の優先度・期限で送信する。
  * T は _traits_::SerializationBufferSizeBytes と serialize(obj, bitspan) を持つこと。
  * tid は呼び出し側で保持し、同一 subject でインクリメントされる。
  */
 template<typename T>
-bool publish(CanardPortID subject_id, CanardTransferID& tid, const T& obj)
+bool publish(CanardPortID subject_id, CanardTransferID& tid, const T& obj,
+             const CyphalTransport::TxOptions& options)
 {
     constexpr std::size_t N = T::_traits_::SerializationBufferSizeBytes;
-    uint8_t buf[N];
+    CyphalTransport& transport = CyphalTransport::instance();
+    uint8_t* const buf = transport.tx_reserve(N);
+    if (buf == nullptr) return false;
     nunavut::support::bitspan span(buf, N, 0U);
+    PROF_BEGIN(prof_start);
     auto result = serialize(obj, span);
-    if (!result) return false;
-    return CyphalTransport::instance().push(subject_id, tid, buf, result.value());
+    PROF_END(PROF_PUBLISH_SERIALIZE, prof_start);
+    if (!result) {
+        transport.tx_cancel();
+        return false;
+    }
+    return transport.tx_commit(subject_id, tid, result.value(), options);
+}
+
+/** subject の既定優先度・期限で送信する。 */
+template<typename T>
+bool publish(CanardPortID subject_id, CanardTransferID& tid, const T& obj)
+{
+    return publish(subject_id, tid, obj, CyphalTransport::instance().tx_options(subject_id));
 }
 
 } // namespace cyphal
@@ -0,0 +1,108 @@
+/**
+ * @file cyphal_subscribe.hpp
+ * @brief 型付き Cyphal Subscribe API（cyphal_publish.hpp の受信側）。
+ *
+ * 責務の分離:
+ * - 型依存: extent (T::_traits_::ExtentBytes)・単一フレームに収まるか（SerializationBufferSizeBytes）・
+ *   deserialize 呼び出し（nunavut C++ 生成に委譲）。
+ * - 型非依存: CyphalTransport::subscribe による canard 登録と O(1) ディスパッチ（transport 層が担当）。
+ *
+ * 使い方:
+ *   #include <uavcan/primitive/scalar/Bit_1_0.hpp>
+ *   using uavcan::primitive::scalar::Bit_1_0;
+ *   auto* sub = cyphal::subscribe<Bit_1_0>(3020U,
+ *       [](const Bit_1_0& msg, const CanardRxTransfer& tr, void* ctx) { ... });
+ *   sub->decode_errors();
+ */
+
+#pragma once
+
+#include "canard.h"
+#include "cyphal_transport.hpp"
+#include "nunavut/support/serialization.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace cyphal {
+
+/**
+ * T 型のサブスクリプション 1 件分の状態。cyphal::subscribe<T>() が静的プールから払い出す。
+ * デシリアライズ先の T は同じ T の全サブスクリプションで共有する
+ * （ディスパッチは CyphalControlTask 上で逐次に行われるため）。
+ */
+template<typename T>
+class Subscription {
+public:
+    using Handler = void (*)(const T& msg, const CanardRxTransfer& transfer, void* context);
+
+    static constexpr std::size_t kExtent = T::_traits_::ExtentBytes;
+    /* 送信側のシリアライズが常に CAN FD の 1 フレームに収まる型（単一フレーム経路の対象） */
+    static constexpr bool kSingleFrame = T::_traits_::SerializationBufferSizeBytes <= CANARD_MTU_CAN_FD - 1U;
+
+    CanardPortID subject_id() const { return subject_id_; }
+    uint32_t     decode_errors() const { return decode_errors_; }
+
+private:
+    template<typename U>
+    friend Subscription<U>* subscribe(CanardPortID, typename Subscription<U>::Handler, void*);
+
+    static void dispatch(const CanardRxTransfer& transfer, void* self);
+
+    static T            msg_;
+    static Subscription pool_[CyphalTransport::kMaxSubscriptions];
+    static std::size_t  pool_used_;
+
+    Handler      handler_{nullptr};
+    void*        context_{nullptr};
+    CanardPortID subject_id_{0};
+    uint32_t     decode_errors_{0};
+};
+
+template<typename T>
+T Subscription<T>::msg_{};
+
+template<typename T>
+Subscription<T> Subscription<T>::pool_[CyphalTransport::kMaxSubscriptions]{};
+
+template<typename T>
+std::size_t Subscription<T>::pool_used_{0};
+
+template<typename T>
+void Subscription<T>::dispatch(const CanardRxTransfer& transfer, void* self)
+{
+    auto* const s = static_cast<Subscription*>(self);
+    nunavut::support::const_bitspan span(
+        static_cast<const uint8_t*>(transfer.payload.data), transfer.payload.size, 0U);
+    if (!deserialize(msg_, span)) {
+        s->decode_errors_++;
+        return;
+    }
+    s->handler_(msg_, transfer, s->context_);
+}
+
+/**
+ * subject_id を T 型として購読する。受信・デシリアライズ成功時に handler(msg, transfer, context)。
+ * extent は T::_traits_::ExtentBytes から決まる。失敗時は nullptr。
+ * CyphalTransport::init() の後、start_fdcan() の前に呼ぶこと。
+ */
+template<typename T>
+Subscription<T>* subscribe(CanardPortID subject_id, typename Subscription<T>::Handler handler,
+                           void* context = nullptr)
+{
+    using Sub = Subscription<T>;
+    if (handler == nullptr || Sub::pool_used_ >= CyphalTransport::kMaxSubscriptions) return nullptr;
+
+    Sub& s = Sub::pool_[Sub::pool_used_];
+    s.handler_       = handler;
+    s.context_       = context;
+    s.subject_id_    = subject_id;
+    s.decode_errors_ = 0;
+    if (!CyphalTransport::instance().subscribe(subject_id, Sub::kExtent, &Sub::dispatch, &s,
+                                               Sub::kSingleFrame)) {
+        return nullptr;
+    }
+    ++Sub::pool_used_;
+    return &s;
+}
+
+} // namespace cyphal
@@ -2,7 +2,9 @@
  * @file cyphal_transport.hpp
  * @brief CyphalTransport: canard インスタンス・TX/RX キュー・FDCAN ブリッジを所有する transport 層。
  *
- * publish は push() を呼ぶ。subscribe はコールバックを渡して subscribe() を呼ぶ。
+ * publish は tx_reserve() した領域へ直接シリアライズして tx_commit() する（シリアライズ済みの
+ * バッファがあるなら push()）。TX のフレーム分割は canard ではなく TxTransferQueue が行う。
+ * subscribe は関数ポインタとコンテキストを渡して subscribe() を呼ぶ。
  * FreeRTOS タスクや application 層はこのクラスに依存してよいが、
  * このクラス自体は application 層 (actuator_command 等) を知らない。
  */
@@ -11,80 +13,291 @@
 
 #include <cstdint>
 #include <cstddef>
-#include <functional>
 #include <array>
 
 #include "canard.h"
 #include "FreeRTOS.h"
-#include "queue.h"
 #include "task.h"
 #include "fdcan.h"
+#include "spsc_ring.hpp"
+#include "tx_transfer_queue.hpp"
+
+/* 1: HW TX FIFO が満杯になったら TX 完了割り込みでタスクを起こして再充填する。
+ * 0: 従来どおり次の RX 通知か wait() のタイムアウトまで待つ（比較計測用）。 */
+#ifndef CYPHAL_TX_IRQ_REFILL
+#define CYPHAL_TX_IRQ_REFILL 1
+#endif
+
+/* 1: RX FIFO0 / TX FIFO の要素をメッセージ RAM から直接読み書きする（fdcan_fast.h）。
+ * 0: HAL_FDCAN_GetRxMessage / HAL_FDCAN_AddMessageToTxFifoQ を使う（比較計測用、ホストの HAL シム）。 */
+#ifndef CYPHAL_FDCAN_FAST_PATH
+#define CYPHAL_FDCAN_FAST_PATH 1
+#endif
+
+/* 1: 常に単一フレームに収まる型の購読（subscribe の single_frame）に限り、メッセージ転送を canard を
+ *    通さず RX リングのスロットから直接ハンドラへ渡す（ペイロードの確保・解放なし）。
+ *    transfer-ID の重複は canard と同じ条件（送信元ごと、transfer_id_timeout_usec 以内）で捨てる。
+ *    単一・マルチフレームが混ざる subject は transfer-ID の列が二つの経路に分かれて重複判定が
+ *    狂うので、その他の購読・マルチフレーム・サービスは従来どおり canardRxAccept。
+ * 0: すべて canardRxAccept を通す（比較計測用）。 */
+#ifndef CYPHAL_RX_SINGLE_FRAME_BYPASS
+#define CYPHAL_RX_SINGLE_FRAME_BYPASS 1
+#endif
 
 class CyphalTransport {
 public:
     static constexpr size_t kMaxSubscriptions = 8;
+    static constexpr size_t kMaxTxSubjects    = 8;  /* subject ごとの送信既定値の登録数 */
+    static constexpr size_t kPriorityCount    = 8;  /* CanardPriorityExceptional .. Optional */
+
+    /**
+     * 送信オプション。priority は CAN ID の上位 3 bit（小さいほど調停に勝つ）。
+     * deadline_usec は commit 時刻からの相対期限で、過ぎた転送は flush_tx() が残りのフレームごと捨てる。
+     */
+    struct TxOptions {
+        CanardPriority priority;
+        uint32_t       deadline_usec;
+    };
+
+    /** set_tx_options() で登録していない subject の既定値。 */
+    static constexpr TxOptions kDefaultTxOptions{CanardPriorityNominal, 100U * 1000U};
+
+    /** RX コールバック。context は subscribe() に渡した値がそのまま渡る。 */
+    using RxHandler = void (*)(const CanardRxTransfer& transfer, void* context);
 
     static CyphalTransport& instance();
 
-    /** canard / TX キュー / RX キューを初期化する。スケジューラ起動前に呼ぶ。 */
+    /**
+     * RX 経路の統計。isr_entries / notifications / task_wakeups の比がバースト時の起床効率を表す。
+     * サイクル数は cycle_profiler（PROF_ISR_RX / PROF_PROCESS_RX）で取る。
+     */
+    struct RxStats {
+        uint32_t frames;         /* isr_rx が FIFO から取り出したフレーム数 */
+        uint32_t transfers;      /* process_rx が完成させた転送数 */
+        uint32_t single_frame;   /* うち canard を通さずに渡した単一フレーム転送 */
+        uint32_t duplicates;     /* 単一フレーム経路で transfer-ID の重複として捨てた転送 */
+        uint32_t isr_entries;    /* isr_rx の呼び出し回数 */
+        uint32_t notifications;  /* isr_rx がタスクへ通知した回数 */
+        uint32_t task_wakeups;   /* wait() が通知で起きた回数 */
+        uint32_t task_timeouts;  /* wait() がタイムアウトで起きた回数 */
+    };
+
+    /**
+     * ISR がタスクを起こす条件。
+     * リングに watermark 個以上たまったときだけ通知する。watermark 未満の残りは
+     * wait() が idle_timeout_ticks で起きて拾う（アイドルライン・タイムアウト）。
+     * watermark = 1 なら受信バーストごとに 1 回通知する。
+     * タイムアウトは ulTaskNotifyTake の待ち時間なので RTOS tick 単位（configTICK_RATE_HZ = 100 なら
+     * 1 tick = 10 ms）。tick 境界の直前に待ち始めるとほぼ 0 で起きるので、実際の待ちは
+     * (idle_timeout_ticks - 1, idle_timeout_ticks] tick になる。0 は 1 tick に切り上げる。
+     */
+    struct RxWakePolicy {
+        uint32_t   watermark;
+        TickType_t idle_timeout_ticks;
+    };
+
+    /** TX 遅延ヒストグラムのビン数。境界は kTxLatencyBinUsec。 */
+    static constexpr size_t kTxLatencyBins = 8;
+
+    /** TX 遅延ビンの上限 [µs]（最後のビンはそれ以上すべて）。 */
+    static constexpr uint32_t kTxLatencyBinUsec[kTxLatencyBins - 1] = {
+        100, 250, 500, 1000, 2500, 5000, 10000,
+    };
+
+    /**
+     * TX 経路の統計。遅延は tx_commit() から FDCAN の HW FIFO に積むまでのフレーム単位の時間。
+     * CYPHAL_TX_IRQ_REFILL=0 でビルドすれば従来のポーリングのみの分布と比較できる。
+     */
+    struct TxStats {
+        uint32_t frames;                          /* HW FIFO に積んだフレーム数 */
+        uint32_t expired[kPriorityCount];         /* flush_tx が期限切れで捨てた転送数（優先度別） */
+        uint32_t expired_frames;                  /* そのうち HW に積めずに捨てたフレーム数（全優先度） */
+        uint32_t queue_full;                      /* TX キューのアリーナに空きがなく tx_reserve が失敗した回数 */
+        uint32_t fifo_full;                       /* HW FIFO 満杯で TX 完了待ちに入った回数 */
+        uint32_t same_id_waits;                   /* 同じ CAN ID が HW で送信待ちのため完了待ちに入った回数 */
+        uint32_t refill_irqs;                     /* TX 完了割り込みでタスクを起こした回数 */
+        uint32_t max_latency_usec;
+        uint32_t latency_hist[kTxLatencyBins];
+    };
+
+    /** canard（RX）/ TX キュー / RX キューを初期化する。スケジューラ起動前に呼ぶ。 */
     bool init(CanardNodeID node_id = 0);
 
     /** タスクハンドルを登録する。CyphalControlTask の先頭で呼ぶ。 */
     void set_task_handle(TaskHandle_t handle);
 
-    /** FDCAN 通知を有効化してコントローラを開始する。 */
+    /**
+     * 受信フィルタを設定し、FDCAN 通知を有効化してコントローラを開始する。
+     * 拡張 ID フィルタは subscribe 済みの subject とサービス宛先（自ノード）から生成する。
+     * フィルタ要素が足りなければ全拡張 ID 受理にフォールバックする。
+     * TX 完了割り込みは登録だけ行い、flush_tx() が HW FIFO 満杯のとき
+     * （キューモードでは同じ CAN ID のフレームが送信待ちのときも）に有効化する。
+     */
     void start_fdcan();
 
+    /** ハードウェアフィルタで絞り込めているか（false なら全拡張 ID 受理）。 */
+    bool rx_hw_filtered() const;
+
+    /** 起床条件を設定する。start_fdcan() の前に呼ぶ。 */
+    void set_rx_wake_policy(const RxWakePolicy& policy);
+
+    /**
+     * RX / TX 完了の通知か max_wait（watermark 待ち中は idle_timeout_ticks）まで待つ。
+     * タスクループから呼ぶ。
+     */
+    void wait(TickType_t max_wait);
+
     /** RX 処理 + TX フラッシュを 1 回実行する。タスクループから呼ぶ。 */
     void step();
 
     /** RX キュー溢れカウンタ。 */
     uint32_t frames_dropped() const;
 
+    /** RX 経路のカウンタ。 */
+    RxStats rx_stats() const;
+
+    /** TX 遅延・再充填の統計。 */
+    TxStats tx_stats() const;
+
+    /** TX キューに残っている（HW FIFO にまだ積んでいない）フレーム数。 */
+    size_t tx_pending() const;
+
+    /**
+     * isr_rx と同じ形で RX リングにフレームを積む（記録・合成ストリームのリプレイ用）。
+     * リングの producer は 1 つだけなので、FDCAN を start_fdcan() する前にだけ使うこと。
+     * リングが満杯なら false。
+     */
+    bool inject_rx(uint32_t can_id, const uint8_t* data, uint8_t size, CanardMicrosecond timestamp_usec);
+
+    /**
+     * subject の送信既定値（優先度・期限）を登録する。登録済みなら上書き。
+     * 表が満杯なら false。init() の後に呼ぶ。
+     */
+    bool set_tx_options(CanardPortID subject_id, const TxOptions& options);
+
+    /** subject の送信既定値。未登録なら kDefaultTxOptions。 */
+    TxOptions tx_options(CanardPortID subject_id) const;
+
+    /**
+     * TX キューに max_size バイトのペイロード領域を予約して返す。空きがなければ nullptr。
+     * 呼び出し側はそこへ直接シリアライズし、tx_commit() か tx_cancel() で終える。
+     * 予約から commit までの間に step() を呼ばないこと。
+     */
+    uint8_t* tx_reserve(size_t max_size);
+
     /**
-     * シリアライズ済みペイロードを TX キューに積む。
+     * 予約した領域の先頭 size バイトを、subject へのメッセージ転送として TX キューに積む。
+     * transfer_id はインクリメントされる（呼び出し側が管理）。
+     * 匿名ノード（node_id 未設定）は単一フレーム転送だけ送れる。
+     */
+    bool tx_commit(CanardPortID subject_id, CanardTransferID& transfer_id, size_t size,
+                   const TxOptions& options);
+
+    /** tx_reserve() の予約を取り消す（シリアライズ失敗時）。 */
+    void tx_cancel();
+
+    /**
+     * シリアライズ済みペイロードを subject の既定優先度・期限で TX キューに積む（コピーあり）。
      * transfer_id はインクリメントされる（呼び出し側が管理）。
      */
     bool push(CanardPortID subject_id, CanardTransferID& transfer_id,
               const uint8_t* payload, size_t size);
 
+    /** 優先度・期限を明示して TX キューに積む。 */
+    bool push(CanardPortID subject_id, CanardTransferID& transfer_id,
+              const uint8_t* payload, size_t size, const TxOptions& options);
+
     /**
      * RX サブスクリプションを登録する。
-     * 対応する転送を受信すると callback が呼ばれる。
+     * 対応する転送を受信すると handler(transfer, context) が呼ばれる。
      * init() の後、start_fdcan() の前に呼ぶこと。
+     * プールのバックエンドでは extent が APP_MEMORY_REASSEMBLY_SIZE を超えると false。
+     * single_frame は送信側が常に 1 フレーム（CAN FD で 63 バイト以下）で送る型のときだけ true にする
+     * （CYPHAL_RX_SINGLE_FRAME_BYPASS の対象になる）。
      */
     bool subscribe(CanardPortID subject_id, size_t extent,
-                   std::function<void(const CanardRxTransfer&)> callback);
+                   RxHandler handler, void* context = nullptr, bool single_frame = false);
 
     /** ISR から呼ぶ。HAL_FDCAN_RxFifo0Callback の実体。 */
     void isr_rx(FDCAN_HandleTypeDef* hfdcan);
 
+    /** ISR から呼ぶ。HAL_FDCAN_TxBufferCompleteCallback の実体。 */
+    void isr_tx_complete(FDCAN_HandleTypeDef* hfdcan);
+
 private:
     struct RxFrame {
-        uint32_t can_id;
-        uint8_t  size;
-        uint8_t  data[CANARD_MTU_CAN_FD];
+        CanardMicrosecond timestamp_usec;  /* isr_rx で FIFO から取り出した時刻 */
+        uint32_t          can_id;
+        uint8_t           size;
+        uint8_t           data[CANARD_MTU_CAN_FD];
     };
 
+    /**
+     * 単一フレーム経路の重複検出用に、送信元ごとの最後の transfer-ID と受信時刻を持つ
+     * （canard の RX セッションのうち単一フレームに要る部分だけ）。
+     */
+    struct RxSession {
+        CanardMicrosecond timestamp_usec;  /* 最後に渡した転送の受信時刻 */
+        CanardNodeID      node_id;         /* CANARD_NODE_ID_UNSET なら空き */
+        CanardTransferID  transfer_id;
+    };
+
+    /* subject ごとに覚える送信元の数。溢れたら最も古い送信元を追い出す（次の転送は新しいセッション扱い）。 */
+    static constexpr size_t kRxSessionsPerSub = 8;
+
+    /* entry.user_reference は自分自身を指す。受信時に canard が返す entry から O(1) で引く。 */
     struct Sub {
-        CanardRxSubscription                         entry;
-        std::function<void(const CanardRxTransfer&)> callback;
+        CanardRxSubscription entry;
+        RxHandler            handler;
+        void*                context;
+        bool                 single_frame;  /* 単一フレーム経路で受けてよい（subscribe の引数） */
+        std::array<RxSession, kRxSessionsPerSub> sessions;
+    };
+
+    struct TxSubject {
+        CanardPortID subject_id;
+        TxOptions    options;
     };
 
+    static constexpr uint32_t kRxQueueLen      = 16;  /* SpscRing のため 2 のべき乗 */
+    static constexpr uint32_t kTxBuffers       = 3;   /* G4 の TX バッファ数 */
+
     CanardInstance  canard_{};
-    CanardTxQueue   tx_queue_{};
-    QueueHandle_t   rx_queue_{nullptr};
+    TxTransferQueue tx_queue_{};
+    uint8_t*        tx_reserved_{nullptr};  /* tx_reserve() が返した領域（tx_commit まで） */
     TaskHandle_t    task_handle_{nullptr};
     uint32_t        frames_dropped_{0};
+    RxStats         rx_stats_{};
+    TxStats         tx_stats_{};
+    RxWakePolicy    rx_wake_policy_{1, 1};
+    bool            rx_hw_filtered_{false};
+
+    /* TX バッファごとに最後に積んだ CAN ID（TXBRP と合わせて送信待ちの ID を判定する） */
+    std::array<uint32_t, kTxBuffers> tx_hw_can_id_{};
+
+    /* ISR が直接書き込み、process_rx がその場で読む。溢れた分は rx_discard_ に捨てる。 */
+    SpscRing<RxFrame, kRxQueueLen> rx_ring_{};
+    RxFrame                        rx_discard_{};
 
     std::array<Sub, kMaxSubscriptions> subs_{};
     size_t sub_count_{0};
 
-    static constexpr uint32_t kRxQueueLen      = 16;
-    static constexpr uint32_t kTxQueueCapacity = 64;
-    static constexpr uint32_t kTxDeadlineMs    = 100;
+    std::array<TxSubject, kMaxTxSubjects> tx_subjects_{};
+    size_t tx_subject_count_{0};
 
+    bool configure_rx_filters();
     void process_rx();
+    bool deliver_single_frame(const RxFrame& frame);
+    Sub* find_sub(CanardPortID subject_id);
+    static bool rx_duplicate(Sub& s, CanardNodeID source, CanardTransferID transfer_id,
+                             CanardMicrosecond timestamp_usec);
+    void dispatch(const Sub& s, const CanardRxTransfer& transfer);
     void flush_tx();
+    void arm_tx_complete();
+    bool tx_id_pending(uint32_t can_id) const;
+    bool tx_buffer_free() const;
+    static bool read_rx_element(FDCAN_HandleTypeDef* hfdcan, RxFrame& frame);
+    static bool add_tx_element(const TxTransferQueue::Frame& frame);
+    void record_tx_latency(const TxTransferQueue::Transfer& transfer, CanardMicrosecond now_usec);
     static uint8_t dlc_to_len(uint32_t dlc);
 };
@@ -0,0 +1,42 @@
+/**
+ * @file fdcan_fast.h
+ * @brief FDCAN のメッセージ RAM を直接読み書きする RX FIFO0 / TX FIFO・キュー操作。
+ *
+ * HAL_FDCAN_GetRxMessage / HAL_FDCAN_AddMessageToTxFifoQ の代わりに CyphalTransport が使う
+ * （CYPHAL_FDCAN_FAST_PATH）。ヘッダは 2 ワードのまま組み立て・分解し、ペイロードはワード単位で
+ * コピーする。扱うのは拡張 ID の CAN FD (BRS) データフレームだけ。
+ * HAL の状態チェックは省くので、HAL_FDCAN_Start() の後にだけ呼ぶこと。
+ * RX FIFO0 はブロッキングモード前提（上書きモードの GetIndex 補正はしない）。
+ */
+
+#ifndef FDCAN_FAST_H
+#define FDCAN_FAST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * RX FIFO0 の先頭要素を読み出して解放する。空なら false。
+ * data には DLC から決まる長さ（最大 64 バイト）を書き、*size にその長さを返す。
+ */
+bool fdcan_fast_rx_fifo0_get(FDCAN_HandleTypeDef* hfdcan, uint32_t* can_id, uint8_t* size, uint8_t* data);
+
+/**
+ * TX FIFO/キューの put index の要素に書き込んで送信要求を出す。満杯なら false。
+ * dlc は DLC コード（0..15）。データは head[0..head_len)、ゼロ詰め、trailer[0..trailer_len) の順で、
+ * 合計が DLC の長さになる（head_len + trailer_len <= 長さ）。
+ * 使ったバッファは HAL_FDCAN_GetLatestTxFifoQRequestBuffer() で引ける。
+ */
+bool fdcan_fast_tx_add(FDCAN_HandleTypeDef* hfdcan, uint32_t can_id, uint32_t dlc,
+                       const uint8_t* head, uint32_t head_len, const uint8_t* trailer, uint32_t trailer_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FDCAN_FAST_H */
@@ -0,0 +1,32 @@
+/**
+ * @file mono_clock.h
+ * @brief TIM17 (1 MHz フリーランニング) を拡張した 64-bit µs 単調時計。
+ *
+ * libcanard に渡す CanardMicrosecond はすべてここから取る。
+ * TIM17 の 16-bit カウンタを更新割り込みで上位 32-bit に拡張するため、
+ * 約 8.9 年はラップしない。タスク・ISR どちらからも呼べる。
+ */
+
+#ifndef MONO_CLOCK_H
+#define MONO_CLOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/** TIM17 を更新割り込み付きで起動する。スケジューラ起動前、transport より先に呼ぶ。 */
+void mono_clock_init(void);
+
+/** 起動からの経過時間 [µs]。 */
+uint64_t mono_clock_usec(void);
+
+/** TIM17 更新割り込み (HAL_TIM_PeriodElapsedCallback) から呼ぶ。 */
+void mono_clock_isr_overflow(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MONO_CLOCK_H */
@@ -0,0 +1,54 @@
+/**
+ * @file servo_trajectory.h
+ * @brief サーボ目標値の補間と速度・加速度制限（actuator_command と actuator_output の間）。
+ *
+ * 目標値は -1..1（actuator_output_apply と同じ正規化単位）、速度・加速度はその単位の /s, /s²。
+ * 新しい目標値は RX のタイムスタンプ付きで渡し、前回の目標値からの間隔をかけて補間する
+ * （次の目標値が同じ間隔で来る前提）。間隔が SERVO_TRAJ_MAX_SEGMENT_USEC を超えたら補間せず、制限だけかける。
+ * ActuatorTask の周期ごとに servo_trajectory_step() を呼ぶ。init / configure 以外は ActuatorTask からのみ呼ぶこと。
+ */
+
+#ifndef SERVO_TRAJECTORY_H
+#define SERVO_TRAJECTORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define SERVO_TRAJ_CHANNELS          4U
+#define SERVO_TRAJ_MAX_SEGMENT_USEC  200000U
+
+typedef enum {
+    SERVO_TRAJ_STEP = 0,  /* 補間なし（制限だけ） */
+    SERVO_TRAJ_LINEAR,    /* 目標値間を直線補間 */
+    SERVO_TRAJ_CUBIC,     /* 3 次エルミート補間（終端速度は直近 2 目標値の傾き） */
+} ServoTrajMode;
+
+typedef struct {
+    ServoTrajMode mode;
+    float         max_velocity;      /* [1/s]、0 で無制限 */
+    float         max_acceleration;  /* [1/s²]、0 で無制限 */
+} ServoTrajConfig;
+
+/** 全チャネルを既定設定・中立・静止にする。 */
+void servo_trajectory_init(void);
+
+/** チャネルの設定を変える。 */
+void servo_trajectory_configure(uint8_t channel, const ServoTrajConfig* config);
+
+/** 新しい目標値。stamp_usec は受信時刻（mono_clock）。 */
+void servo_trajectory_set_target(uint8_t channel, float setpoint, uint64_t stamp_usec);
+
+/** 全チャネルを中立・静止に戻す（非 engage 時・タイムアウト時。設定は保持）。 */
+void servo_trajectory_reset(void);
+
+/** now_usec 時点の出力を out[SERVO_TRAJ_CHANNELS] に書く。 */
+void servo_trajectory_step(uint64_t now_usec, float out[SERVO_TRAJ_CHANNELS]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SERVO_TRAJECTORY_H */
@@ -0,0 +1,64 @@
+/**
+ * @file snapshot_latch.hpp
+ * @brief 単一 writer / 複数 reader の lock-free スナップショット（シーケンスカウンタ + 2 面バッファ）。
+ *
+ * 複数フィールドからなる状態を、reader が常に「ある時点で writer が公開した値そのもの」として読めるようにする。
+ * writer は 2 面を順に書き換え、書き換え中でない面の番号をシーケンスカウンタの偶奇で示す。
+ *
+ * - reader が writer より高優先度（ISR / 上位タスク）: writer に割り込んでも書き換え中でない面を読むので、
+ *   リトライは起きない（単純な seqlock だと writer が進めずに reader が回り続ける）。
+ * - reader が writer より低優先度: 読んでいる間に公開があればリトライする。
+ *
+ * writer は 1 コンテキストに限る。T はトリビアルにコピーできる型。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+template<typename T>
+class SnapshotLatch {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+public:
+    /** reader: 最後に公開された値。 */
+    T load() const
+    {
+        T out;
+        uint32_t seq;
+        do {
+            seq = seq_.load(std::memory_order_acquire);
+            out = copies_[seq & 1U];
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (seq_.load(std::memory_order_relaxed) != seq);
+        return out;
+    }
+
+    /** writer: value を公開する。 */
+    void store(const T& value)
+    {
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        /* 奇数: reader は copies_[1]。前回の末尾で書いた copies_[1] を、奇数を見た reader に見せるため release
+         * （フェンスは続く copies_[0] の書き込みのために残す）。 */
+        seq_.store(seq + 1U, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        copies_[0] = value;
+        seq_.store(seq + 2U, std::memory_order_release);   /* 偶数: reader は copies_[0] */
+        copies_[1] = value;
+    }
+
+    /** writer: 公開中の値を modify(T&) で書き換えて公開する。 */
+    template<typename F>
+    void update(F&& modify)
+    {
+        T next = copies_[0];  /* writer 自身は書き換え途中を見ない */
+        modify(next);
+        store(next);
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    T                     copies_[2]{};
+};
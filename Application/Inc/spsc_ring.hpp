@@ -0,0 +1,66 @@
+/**
+ * @file spsc_ring.hpp
+ * @brief 単一 producer / 単一 consumer の lock-free リングバッファ（静的確保）。
+ *
+ * ISR (producer) とタスク (consumer) の受け渡し用。スロットを直接読み書きする
+ * ゼロコピー API なので、要素のコピーもクリティカルセクションも発生しない。
+ *
+ * producer: acquire() で空きスロットを取り、書き込んでから commit()。
+ * consumer: front() で先頭スロットを参照し、使い終わったら release()。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template<typename T, std::size_t N>
+class SpscRing {
+    static_assert(N >= 2U && (N & (N - 1U)) == 0U, "N must be a power of two");
+
+public:
+    static constexpr std::size_t kCapacity  = N;
+    static constexpr std::size_t kCacheLine = 32U;
+
+    /** producer: 書き込み先スロット。満杯なら nullptr。 */
+    T* acquire()
+    {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const uint32_t tail = tail_.load(std::memory_order_acquire);
+        if ((head - tail) >= N) return nullptr;
+        return &slots_[head & (N - 1U)];
+    }
+
+    /** producer: acquire() で得たスロットを consumer に公開する。 */
+    void commit()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+    }
+
+    /** consumer: 先頭スロット。空なら nullptr。 */
+    const T* front() const
+    {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const uint32_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) return nullptr;
+        return &slots_[tail & (N - 1U)];
+    }
+
+    /** consumer: front() のスロットを producer に返す。 */
+    void release()
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+    }
+
+    /** 現在の要素数（どちら側から呼んでも概算として使える）。 */
+    std::size_t size() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(kCacheLine) std::atomic<uint32_t> head_{0};
+    alignas(kCacheLine) std::atomic<uint32_t> tail_{0};
+    alignas(kCacheLine) T slots_[N]{};
+};
@@ -0,0 +1,42 @@
+/**
+ * @file transfer_crc.h
+ * @brief Cyphal/CAN のマルチフレーム転送 CRC（CRC-16/CCITT-FALSE）。
+ *
+ * TRANSFER_CRC_HW=1（実機の既定）では STM32G4 の CRC ユニット（16 ビット多項式 0x1021、
+ * 反転なし）で 4 バイトずつ計算し、0（ホスト）では 256 エントリ表のソフトウェア実装を使う。
+ * libcanard 内部の CRC（canard.c の crcAdd）は差し替えられないので、
+ * フレームを自前で組み立てる・検査する経路がこちらを使う。
+ * CRC ユニットは 1 つしかないので、transfer_crc_add() は 1 つのタスクからだけ呼ぶこと。
+ */
+
+#ifndef TRANSFER_CRC_H
+#define TRANSFER_CRC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef TRANSFER_CRC_HW
+#define TRANSFER_CRC_HW 1
+#endif
+
+/** 転送 CRC の初期値。 */
+#define TRANSFER_CRC_INITIAL  0xFFFFU
+
+/** CRC ユニットのクロックと多項式を設定する（TRANSFER_CRC_HW=0 では何もしない）。 */
+void transfer_crc_init(void);
+
+/** crc に data[0..size) を続けて畳み込んだ値を返す。転送の先頭では TRANSFER_CRC_INITIAL を渡す。 */
+uint16_t transfer_crc_add(uint16_t crc, const void* data, size_t size);
+
+/** ソフトウェア実装（表引き）。比較計測用に HW ビルドでも使える。 */
+uint16_t transfer_crc_add_sw(uint16_t crc, const void* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRANSFER_CRC_H */
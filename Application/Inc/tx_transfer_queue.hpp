@@ -0,0 +1,118 @@
+/**
+ * @file tx_transfer_queue.hpp
+ * @brief 送信転送をシリアライズ先のバッファのまま保持し、flush 時に 1 フレームずつ切り出す TX キュー。
+ *
+ * canardTxPush はペイロードをフレームごとのヒープ領域へコピーするが、こちらは
+ * reserve() で返したアリーナ内の領域へ直接シリアライズさせ、commit() で転送として積む。
+ * フレーム分割（テールバイト・ゼロ詰め・マルチフレーム CRC）は next_frame() が
+ * 送信時にその場で組み立てるので、ペイロードはアリーナから HW の要素へ 1 回コピーされるだけ。
+ *
+ * アリーナは転送ヘッダ + ペイロードを 8 バイト境界で並べたブロックの列で、送信・破棄済みの
+ * ブロックは空きに戻り、reserve() が先頭から最初に収まる空き（隣り合う空きは連結する）を使う。
+ * 送信順は優先度順（同じ優先度は commit 順）で commit 順とは限らないので、古い低優先度の転送が
+ * 残っていても、その後ろで送信済みになった領域は高優先度の転送がすぐに使える。
+ * CyphalControlTask からだけ使うこと（排他はしない）。
+ *
+ * シリアライズはフレーム単位に分けて流し込まず、最大長（SerializationBufferSizeBytes）の連続領域へ
+ * 1 回で行う（nunavut のシリアライザは連続バッファを取るため）。最大長の予約は commit() で実際の長さに
+ * 縮め、余りはすぐ空きに戻す。
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "canard.h"
+
+class TxTransferQueue {
+public:
+    static constexpr size_t kArenaBytes    = 2048;
+    static constexpr size_t kFramePayload  = CANARD_MTU_CAN_FD - 1U;  /* テールバイトを除く */
+    static constexpr size_t kPriorityCount = 8;
+
+    /** アリーナ内の転送ヘッダ。ペイロードはこの直後に続く。 */
+    struct Transfer {
+        Transfer*         next;           /* 同じ優先度の次の転送 */
+        CanardMicrosecond deadline_usec;
+        CanardMicrosecond enqueued_usec;  /* commit() した時刻（TX 遅延の起点） */
+        uint32_t          can_id;
+        uint16_t          size;           /* ペイロード長 */
+        uint16_t          offset;         /* 送信済みのバイト数（ペイロード + CRC の通し位置） */
+        uint16_t          crc;            /* マルチフレームのみ: ペイロード + ゼロ詰めの CRC */
+        uint16_t          span;           /* アリーナ上の占有バイト数（ヘッダ込み） */
+        uint8_t           padding;        /* 最後のフレームのゼロ詰めバイト数 */
+        uint8_t           tail;           /* toggle | transfer-ID（SOT / EOT は next_frame が付ける） */
+        bool              vacant;         /* 空きブロック（送信・破棄済みを含む）。span だけが有効 */
+    };
+
+    /**
+     * 1 フレームの内容。payload（アリーナ内をそのまま参照）、ゼロ詰め、trailer の順に並べると
+     * size バイトになる。trailer は CRC の 0..2 バイトとテールバイト。
+     */
+    struct Frame {
+        uint32_t       can_id;
+        uint8_t        size;
+        uint8_t        payload_size;
+        uint8_t        trailer_size;
+        uint8_t        trailer[3];
+        const uint8_t* payload;
+    };
+
+    /** 空にする。 */
+    void init();
+
+    /**
+     * max_size バイトのペイロード領域を予約して先頭を返す。連続した空きがなければ nullptr。
+     * 予約は次の commit() / cancel() / reserve() まで有効（reserve() は前の予約を取り消す）。
+     */
+    uint8_t* reserve(size_t max_size);
+
+    /**
+     * 予約した領域の先頭 size バイトを転送として積む。can_id は送信元まで含めた完全な ID。
+     * 予約がないか size が予約より大きければ false。
+     */
+    bool commit(uint32_t can_id, CanardTransferID transfer_id, size_t size,
+                CanardMicrosecond now_usec, CanardMicrosecond deadline_usec);
+
+    /** 予約を取り消す。 */
+    void cancel();
+
+    /** 次に送る転送（最も優先度の高いキューの先頭）。空なら nullptr。 */
+    Transfer* front() const;
+
+    /** front() の転送の次のフレーム。 */
+    Frame next_frame(const Transfer& t) const;
+
+    /** next_frame() を HW に積んだ後に呼ぶ。転送の最後のフレームなら取り除いて true。 */
+    bool advance(Transfer& t);
+
+    /** front() の転送を残りのフレームごと捨てる。捨てたフレーム数を返す。 */
+    uint32_t drop(Transfer& t);
+
+    /** まだ HW に積んでいないフレーム数。 */
+    size_t frames_pending() const { return frames_pending_; }
+
+private:
+    static size_t frame_count(size_t size);
+    static uint8_t* payload_of(Transfer* t);
+    static const uint8_t* payload_of(const Transfer* t);
+    Transfer* block_at(size_t offset);
+    void split(size_t offset, size_t span);
+    void pop(Transfer& t);
+
+    static_assert(kArenaBytes <= UINT16_MAX, "Transfer::span is 16-bit");
+
+    /* [0, kArenaBytes) を隙間なく覆うブロックの列。各ブロックの先頭は Transfer ヘッダ。 */
+    alignas(8) std::array<uint8_t, kArenaBytes> arena_{};
+
+    /* 予約中のブロック */
+    size_t res_at_{0};
+    size_t res_size_{0};
+    bool   reserved_{false};
+
+    std::array<Transfer*, kPriorityCount> heads_{};
+    std::array<Transfer*, kPriorityCount> tails_{};
+    size_t frames_pending_{0};
+};
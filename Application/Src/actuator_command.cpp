@@ -2,13 +2,20 @@
  * @file actuator_command.cpp
  * @brief Planar/Bit/Readiness デコード・コマンド状態管理・タイムアウト処理。
  *
- * init() で CyphalTransport にラムダを登録し、受信時にデコードを実行する。
- * C++ DSDL 生成型と deserialize を使用。
+ * init() で cyphal::subscribe<T>() により型付きハンドラを登録する。
+ * デシリアライズとデコードエラーの計数は cyphal_subscribe.hpp 側で行う。
+ *
+ * コマンド状態は RX コールバック（CyphalControlTask）だけが書き、ActuatorTask（上位優先度）が読む。
+ * SnapshotLatch 経由なので、apply は常にどれか 1 回の更新直後の状態をそのまま見る。
+ * サーボ目標値は servo_trajectory で補間・制限してから出力する。
  */
 
 #include "actuator_command.h"
 #include "actuator_output.h"
-#include "cyphal_transport.hpp"
+#include "servo_trajectory.h"
+#include "mono_clock.h"
+#include "cyphal_subscribe.hpp"
+#include "snapshot_latch.hpp"
 #include "FreeRTOS.h"
 #include "task.h"
 #include <reg/udral/physics/dynamics/rotation/Planar_0_1.hpp>
@@ -16,42 +23,76 @@
 #include <uavcan/primitive/scalar/Bit_1_0.hpp>
 #include <cmath>
 
+using reg::udral::physics::dynamics::rotation::Planar_0_1;
+using reg::udral::service::common::Readiness_0_1;
+using uavcan::primitive::scalar::Bit_1_0;
+
 /* Subject IDs (RX) */
 static constexpr CanardPortID kSubjectReadiness   = 3005U;
-static constexpr CanardPortID kSubjectServo0      = 3010U;
-static constexpr CanardPortID kSubjectServo1      = 3011U;
-static constexpr CanardPortID kSubjectServo2      = 3012U;
-static constexpr CanardPortID kSubjectServo3      = 3013U;
+static constexpr CanardPortID kSubjectServo[4]    = { 3010U, 3011U, 3012U, 3013U };
 static constexpr CanardPortID kSubjectPump        = 3020U;
-static constexpr size_t       kExtent             = 64U;
 static constexpr uint32_t     kControlTimeoutMs   = 1000U;
 
-/* コマンド状態 */
-static float      s_servo[4];
-static bool       s_pump_on;
-static uint8_t    s_readiness;
-static TickType_t s_last_cmd_tick;
-static uint32_t   s_decode_errors;
-static uint32_t   s_timeout_count;
-static bool       s_in_timeout;
+/* サーボ subject のコンテキスト（チャネル番号） */
+static uint8_t s_servo_index[4] = { 0, 1, 2, 3 };
+
+/* サブスクリプション（デコードエラー数の参照用） */
+static cyphal::Subscription<Readiness_0_1>* s_sub_readiness;
+static cyphal::Subscription<Planar_0_1>*    s_sub_servo[4];
+static cyphal::Subscription<Bit_1_0>*       s_sub_pump;
+
+/* コマンド状態（writer: RX コールバック / reader: actuator_command_apply） */
+struct CommandState {
+    float      servo[4];
+    uint64_t   servo_stamp_usec[4];  /* 受信時刻。0 は未受信 */
+    bool       pump_on;
+    uint8_t    readiness;
+    TickType_t last_cmd_tick;
+};
+static SnapshotLatch<CommandState> s_command;
+
+/* apply 側だけが触る */
+static uint32_t s_timeout_count;
+static bool     s_in_timeout;
+static uint64_t s_servo_seen_usec[4];  /* servo_trajectory に渡し済みの servo_stamp_usec */
+
+static bool is_timed_out(const CommandState& c, TickType_t now)
+{
+    return (now - c.last_cmd_tick) > pdMS_TO_TICKS(kControlTimeoutMs);
+}
+
+/** RX コールバックから: タイムアウト後の最初の更新は安全状態から始める（古い readiness を引き継がない）。 */
+template<typename F>
+static void update_command(F&& modify)
+{
+    const TickType_t now = xTaskGetTickCount();
+    s_command.update([&](CommandState& c) {
+        if (is_timed_out(c, now)) {
+            c = CommandState{};
+        }
+        modify(c);
+        c.last_cmd_tick = now;
+    });
+}
+
+/** 軌道を中立から始め直す（再 engage 時は最新の目標値へ制限付きで動く）。 */
+static void reset_trajectory()
+{
+    servo_trajectory_reset();
+    for (int i = 0; i < 4; i++) s_servo_seen_usec[i] = 0;
+}
 
 static void apply_safe_state()
 {
-    s_readiness = 0;
-    s_pump_on   = false;
-    for (int i = 0; i < 4; i++) s_servo[i] = 0.0f;
-    actuator_output_apply(s_servo, s_pump_on, s_readiness);
+    static const float kZero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    reset_trajectory();
+    actuator_output_apply(kZero, false, 0);
 }
 
-static void decode_planar(uint8_t idx, const uint8_t* payload, size_t size)
+static void on_planar(const Planar_0_1& msg, const CanardRxTransfer& transfer, void* ctx)
 {
+    const uint8_t idx = *static_cast<const uint8_t*>(ctx);
     if (idx >= 4) return;
-    reg::udral::physics::dynamics::rotation::Planar_0_1 msg{};
-    nunavut::support::const_bitspan span(payload, size, 0U);
-    if (!deserialize(msg, span)) {
-        s_decode_errors++;
-        return;
-    }
     float sp = 0.0f;
     const float pos = msg.kinematics.angular_position.radian;
     const float vel = msg.kinematics.angular_velocity.radian_per_second;
@@ -59,90 +100,76 @@ static void decode_planar(uint8_t idx, const uint8_t* payload, size_t size)
     else if (std::isfinite(vel)) sp = vel;
     if (sp >  1.0f) sp =  1.0f;
     if (sp < -1.0f) sp = -1.0f;
-    s_servo[idx] = sp;
+    update_command([&](CommandState& c) {
+        c.servo[idx]            = sp;
+        c.servo_stamp_usec[idx] = transfer.timestamp_usec;
+    });
 }
 
-static void decode_bit(const uint8_t* payload, size_t size)
+static void on_bit(const Bit_1_0& msg, const CanardRxTransfer&, void*)
 {
-    if (size < 1) return;
-    uavcan::primitive::scalar::Bit_1_0 msg{};
-    nunavut::support::const_bitspan span(payload, size, 0U);
-    if (!deserialize(msg, span)) {
-        s_decode_errors++;
-        return;
-    }
-    s_pump_on = msg.value;
+    update_command([&](CommandState& c) { c.pump_on = msg.value; });
 }
 
-static void decode_readiness(const uint8_t* payload, size_t size)
+static void on_readiness(const Readiness_0_1& msg, const CanardRxTransfer&, void*)
 {
-    if (size < 1) return;
-    reg::udral::service::common::Readiness_0_1 msg{};
-    nunavut::support::const_bitspan span(payload, size, 0U);
-    if (!deserialize(msg, span)) {
-        s_decode_errors++;
-        return;
-    }
-    s_readiness = msg.value & 3u;
+    update_command([&](CommandState& c) { c.readiness = msg.value & 3u; });
 }
 
 extern "C" void actuator_command_init(void)
 {
-    s_pump_on       = false;
-    s_readiness     = 0;
-    s_last_cmd_tick = 0;
-    s_decode_errors = 0;
+    s_command.store(CommandState{});
     s_timeout_count = 0;
     s_in_timeout    = false;
-    for (int i = 0; i < 4; i++) s_servo[i] = 0.0f;
+    servo_trajectory_init();
     actuator_output_init();
     apply_safe_state();
 
-    auto& t = CyphalTransport::instance();
-
-    t.subscribe(kSubjectReadiness, kExtent, [](const CanardRxTransfer& tr) {
-        s_last_cmd_tick = xTaskGetTickCount();
-        decode_readiness(static_cast<const uint8_t*>(tr.payload.data), tr.payload.size);
-    });
-    t.subscribe(kSubjectServo0, kExtent, [](const CanardRxTransfer& tr) {
-        s_last_cmd_tick = xTaskGetTickCount();
-        decode_planar(0, static_cast<const uint8_t*>(tr.payload.data), tr.payload.size);
-    });
-    t.subscribe(kSubjectServo1, kExtent, [](const CanardRxTransfer& tr) {
-        s_last_cmd_tick = xTaskGetTickCount();
-        decode_planar(1, static_cast<const uint8_t*>(tr.payload.data), tr.payload.size);
-    });
-    t.subscribe(kSubjectServo2, kExtent, [](const CanardRxTransfer& tr) {
-        s_last_cmd_tick = xTaskGetTickCount();
-        decode_planar(2, static_cast<const uint8_t*>(tr.payload.data), tr.payload.size);
-    });
-    t.subscribe(kSubjectServo3, kExtent, [](const CanardRxTransfer& tr) {
-        s_last_cmd_tick = xTaskGetTickCount();
-        decode_planar(3, static_cast<const uint8_t*>(tr.payload.data), tr.payload.size);
-    });
-    t.subscribe(kSubjectPump, kExtent, [](const CanardRxTransfer& tr) {
-        s_last_cmd_tick = xTaskGetTickCount();
-        decode_bit(static_cast<const uint8_t*>(tr.payload.data), tr.payload.size);
-    });
+    s_sub_readiness = cyphal::subscribe<Readiness_0_1>(kSubjectReadiness, on_readiness);
+    for (int i = 0; i < 4; i++) {
+        s_sub_servo[i] = cyphal::subscribe<Planar_0_1>(kSubjectServo[i], on_planar, &s_servo_index[i]);
+    }
+    s_sub_pump = cyphal::subscribe<Bit_1_0>(kSubjectPump, on_bit);
 }
 
 extern "C" void actuator_command_apply(void)
 {
-    const TickType_t now = xTaskGetTickCount();
-    if ((now - s_last_cmd_tick) > pdMS_TO_TICKS(kControlTimeoutMs)) {
+    const CommandState c = s_command.load();
+    if (is_timed_out(c, xTaskGetTickCount())) {
         if (!s_in_timeout) {
             s_timeout_count++;
             s_in_timeout = true;
         }
         apply_safe_state();
+    } else if (c.readiness != 3u) {
+        /* 非 engage: 出力は中立（actuator_output 側） */
+        s_in_timeout = false;
+        reset_trajectory();
+        actuator_output_apply(c.servo, c.pump_on, c.readiness);
     } else {
         s_in_timeout = false;
-        actuator_output_apply(s_servo, s_pump_on, s_readiness);
+        for (uint8_t i = 0; i < 4; i++) {
+            if (c.servo_stamp_usec[i] != s_servo_seen_usec[i]) {
+                servo_trajectory_set_target(i, c.servo[i], c.servo_stamp_usec[i]);
+                s_servo_seen_usec[i] = c.servo_stamp_usec[i];
+            }
+        }
+        float servo[4];
+        servo_trajectory_step(mono_clock_usec(), servo);
+        actuator_output_apply(servo, c.pump_on, c.readiness);
     }
 }
 
 extern "C" void actuator_command_get_stats(uint32_t* decode_errors, uint32_t* timeout_count)
 {
-    if (decode_errors != nullptr) *decode_errors = s_decode_errors;
+    if (decode_errors != nullptr) {
+        uint32_t sum = 0;
+        if (s_sub_readiness != nullptr) sum += s_sub_readiness->decode_errors();
+        for (int i = 0; i < 4; i++) {
+            if (s_sub_servo[i] != nullptr) sum += s_sub_servo[i]->decode_errors();
+        }
+        if (s_sub_pump != nullptr) sum += s_sub_pump->decode_errors();
+        *decode_errors = sum;
+    }
     if (timeout_count != nullptr) *timeout_count = s_timeout_count;
 }
@@ -0,0 +1,75 @@
+/**
+ * @file actuator_loop.c
+ * @brief ActuatorTask: applies the command state once per TIM2 update event (servo PWM period).
+ */
+
+#include "actuator_loop.h"
+#include "actuator_command.h"
+#include "mono_clock.h"
+#include "tim.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Fall back to applying on a timeout if the update IRQ stops (keeps the command timeout alive). */
+#define ACTUATOR_LOOP_TIMEOUT_MS  (2U * ACTUATOR_LOOP_PERIOD_USEC / 1000U)
+
+static TaskHandle_t      s_task;
+static volatile uint64_t s_event_usec;
+static ActuatorLoopStats s_stats;
+
+void actuator_loop_isr_period(void)
+{
+    if (s_task == NULL) {
+        return;
+    }
+    s_event_usec = mono_clock_usec();
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void actuator_loop_get_stats(ActuatorLoopStats* out)
+{
+    *out = s_stats;
+}
+
+void ActuatorTask(void* pvParameters)
+{
+    (void)pvParameters;
+    s_task = xTaskGetCurrentTaskHandle();
+
+    __HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_UPDATE);
+    __HAL_TIM_ENABLE_IT(&htim2, TIM_IT_UPDATE);
+
+    uint64_t last_start = 0;
+    for (;;) {
+        const uint32_t events = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ACTUATOR_LOOP_TIMEOUT_MS));
+        const uint64_t start  = mono_clock_usec();
+
+        if (events == 0U) {
+            s_stats.timeouts++;
+            last_start = 0;
+        } else {
+            if (events > 1U) {
+                s_stats.overruns += events - 1U;
+            }
+            const uint32_t latency = (uint32_t)(start - s_event_usec);
+            if (latency > s_stats.max_latency_usec) {
+                s_stats.max_latency_usec = latency;
+            }
+            if (last_start != 0U && events == 1U) {
+                const uint32_t interval = (uint32_t)(start - last_start);
+                const uint32_t jitter   = (interval > ACTUATOR_LOOP_PERIOD_USEC)
+                                              ? interval - ACTUATOR_LOOP_PERIOD_USEC
+                                              : ACTUATOR_LOOP_PERIOD_USEC - interval;
+                if (jitter > s_stats.max_jitter_usec) {
+                    s_stats.max_jitter_usec = jitter;
+                }
+            }
+            last_start = start;
+        }
+
+        actuator_command_apply();
+        s_stats.periods++;
+    }
+}
@@ -1,31 +1,128 @@
 /**
  * @file actuator_output.c
  * @brief Apply servo (TIM2) and pump (TIM1 + PF1) from command state.
+ *
+ * Servo calibrations are precomputed into integer scale/offset in timer ticks, so each update
+ * is one float-to-Q15 conversion followed by a multiply-add-clamp per channel.
+ *
+ * With ACTUATOR_OUTPUT_DMA_BURST the CPU only fills s_servo_ccr; the TIM2 update DMA request
+ * (circular, 4-word burst into DMAR) commits it. OC preload is turned off in that mode: the burst
+ * lands right after the update event, at a counter value far below any servo compare, so the
+ * new pulses take effect in the period that has just started (same latency as preloaded writes).
  */
 
 #include "actuator_output.h"
+#include "cycle_profiler.h"
 #include "tim.h"
 #include "main.h"
-#include <math.h>
 
-#define SERVO_NEUTRAL_US  1500   /* center [us] */
-#define SERVO_MIN_US       900   /* lower limit [us] */
-#define SERVO_MAX_US      2100   /* upper limit [us] */
-#define SERVO_RANGE_US     600   /* half range: (2100 - 1500) = 600; setpoint ±1 → min/max */
+#define SERVO_NEUTRAL_US  1500   /* default center [us] */
+#define SERVO_MIN_US       900   /* default lower limit [us] */
+#define SERVO_MAX_US      2100   /* default upper limit [us] */
 #define SERVO_PERIOD_TICKS 19999
+#define SERVO_PERIOD_US    20000
+#define SERVO_COUNT        4
+#define SETPOINT_Q         15     /* setpoints are converted to Q15 once per update */
 #define PUMP_DUTY_FIXED    400
 #define PUMP_PERIOD        999
 
-static uint32_t setpoint_to_servo_ticks(float setpoint)
+/* Precomputed mapping: ticks = neutral + ((q * scale) >> SETPOINT_Q), clamped to [min, max].
+ * scale_pos applies to q >= 0 and scale_neg to q < 0; both are negated for reversed servos.
+ * q spans +-2^15, so +-1.0 lands exactly on max / min. The shift floors the product, matching
+ * the truncation of the former float path (within one tick where the Q15 step falls on a boundary). */
+typedef struct {
+    int32_t neutral;
+    int32_t min;
+    int32_t max;
+    int32_t scale_pos;
+    int32_t scale_neg;
+} ServoMap;
+
+
+static ServoMap s_servo_map[SERVO_COUNT];
+
+#if ACTUATOR_OUTPUT_DMA_BURST
+static volatile uint32_t s_servo_ccr[SERVO_COUNT];  /* CCR1..CCR4 image read by the DMA burst */
+#else
+static const uint32_t s_servo_channel[SERVO_COUNT] = {
+    TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4
+};
+#endif
+
+static void write_servo(uint8_t channel, uint32_t ticks)
 {
-    float pulse_us = (float)SERVO_NEUTRAL_US + setpoint * (float)SERVO_RANGE_US;
-    if (pulse_us < (float)SERVO_MIN_US) pulse_us = (float)SERVO_MIN_US;
-    if (pulse_us > (float)SERVO_MAX_US) pulse_us = (float)SERVO_MAX_US;
-    return (uint32_t)(pulse_us * (float)(SERVO_PERIOD_TICKS + 1) / 20000.0f);
+#if ACTUATOR_OUTPUT_DMA_BURST
+    s_servo_ccr[channel] = ticks;
+#else
+    __HAL_TIM_SET_COMPARE(&htim2, s_servo_channel[channel], ticks);
+#endif
+}
+
+#if ACTUATOR_OUTPUT_DMA_BURST
+static void start_servo_dma_burst(void)
+{
+    TIM_TypeDef* const tim = htim2.Instance;
+    tim->CCMR1 &= ~(TIM_CCMR1_OC1PE | TIM_CCMR1_OC2PE);
+    tim->CCMR2 &= ~(TIM_CCMR2_OC3PE | TIM_CCMR2_OC4PE);
+    tim->DCR = TIM_DMABASE_CCR1 | TIM_DMABURSTLENGTH_4TRANSFERS;
+    if (HAL_DMA_Start(htim2.hdma[TIM_DMA_ID_UPDATE], (uint32_t)s_servo_ccr,
+                      (uint32_t)&tim->DMAR, SERVO_COUNT) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_TIM_ENABLE_DMA(&htim2, TIM_DMA_UPDATE);
+}
+#endif
+
+static int32_t us_to_ticks(uint16_t us)
+{
+    return (int32_t)(((uint32_t)us * (SERVO_PERIOD_TICKS + 1U)) / SERVO_PERIOD_US);
+}
+
+static void build_map(ServoMap* m, const ServoCalibration* cal)
+{
+    m->neutral = us_to_ticks(cal->neutral_us);
+    m->min     = us_to_ticks(cal->min_us);
+    m->max     = us_to_ticks(cal->max_us);
+    if (cal->reversed) {
+        m->scale_pos = -(m->neutral - m->min);
+        m->scale_neg = -(m->max - m->neutral);
+    } else {
+        m->scale_pos = m->max - m->neutral;
+        m->scale_neg = m->neutral - m->min;
+    }
+}
+
+static uint32_t setpoint_to_servo_ticks(const ServoMap* m, float setpoint)
+{
+    if (setpoint > 1.0f) setpoint = 1.0f;
+    if (!(setpoint >= -1.0f)) setpoint = -1.0f;   /* also catches NaN */
+    const int32_t q     = (int32_t)(setpoint * (float)(1 << SETPOINT_Q));
+    const int32_t scale = (q >= 0) ? m->scale_pos : m->scale_neg;
+    int32_t ticks = m->neutral + ((q * scale) >> SETPOINT_Q);
+    if (ticks < m->min) ticks = m->min;
+    if (ticks > m->max) ticks = m->max;
+    return (uint32_t)ticks;
+}
+
+void actuator_output_set_calibration(uint8_t channel, const ServoCalibration* cal)
+{
+    if (channel < SERVO_COUNT && cal != NULL &&
+        cal->min_us <= cal->neutral_us && cal->neutral_us <= cal->max_us &&
+        cal->max_us <= SERVO_PERIOD_US) {
+        build_map(&s_servo_map[channel], cal);
+    }
 }
 
 void actuator_output_init(void)
 {
+    static const ServoCalibration kDefault = { SERVO_MIN_US, SERVO_NEUTRAL_US, SERVO_MAX_US, false };
+    for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+        build_map(&s_servo_map[i], &kDefault);
+        write_servo(i, (uint32_t)s_servo_map[i].neutral);
+    }
+#if ACTUATOR_OUTPUT_DMA_BURST
+    start_servo_dma_burst();
+#endif
     HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_1);
     HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_2);
     HAL_TIM_PWM_Start(&htim2, TIM_CHANNEL_3);
@@ -33,24 +130,21 @@ void actuator_output_init(void)
     HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
 }
 
-void actuator_output_apply(const float servo_setpoints[4], bool pump_on, uint8_t readiness)
+static void apply_outputs(const float servo_setpoints[4], bool pump_on, uint8_t readiness)
 {
     const bool engaged = (readiness == 3u);
     if (!engaged) {
-        const uint32_t neutral = setpoint_to_servo_ticks(0.0f);
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, neutral);
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_2, neutral);
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_3, neutral);
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_4, neutral);
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            write_servo(i, (uint32_t)s_servo_map[i].neutral);
+        }
         __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, 0);
         HAL_GPIO_WritePin(GPIOF, GPIO_PIN_1, GPIO_PIN_RESET);
         return;
     }
     if (servo_setpoints != NULL) {
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_1, setpoint_to_servo_ticks(servo_setpoints[0]));
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_2, setpoint_to_servo_ticks(servo_setpoints[1]));
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_3, setpoint_to_servo_ticks(servo_setpoints[2]));
-        __HAL_TIM_SET_COMPARE(&htim2, TIM_CHANNEL_4, setpoint_to_servo_ticks(servo_setpoints[3]));
+        for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+            write_servo(i, setpoint_to_servo_ticks(&s_servo_map[i], servo_setpoints[i]));
+        }
     }
     if (pump_on) {
         __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, PUMP_DUTY_FIXED);
@@ -60,3 +154,10 @@ void actuator_output_apply(const float servo_setpoints[4], bool pump_on, uint8_t
         HAL_GPIO_WritePin(GPIOF, GPIO_PIN_1, GPIO_PIN_RESET);
     }
 }
+
+void actuator_output_apply(const float servo_setpoints[4], bool pump_on, uint8_t readiness)
+{
+    PROF_BEGIN(prof_start);
+    apply_outputs(servo_setpoints, pump_on, readiness);
+    PROF_END(PROF_ACTUATOR_APPLY, prof_start);
+}
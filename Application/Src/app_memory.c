@@ -1,11 +1,144 @@
 /**
  * @file app_memory.c
- * @brief FreeRTOS heap_4 allocator wrappers for libcanard.
+ * @brief libcanard allocators: fixed-block pools or FreeRTOS heap_4 wrappers.
  */
 
 #include "app_memory.h"
 #include "canard.h"
 #include "FreeRTOS.h"
+#include <stdbool.h>
+#include <string.h>
+
+static AppMemoryStats s_stats;
+
+#if APP_MEMORY_BACKEND == APP_MEMORY_BACKEND_POOL
+
+#define POOL_ALIGN(n)         (((n) + 7U) & ~(size_t)7U)
+
+#define POOL_SESSION_SIZE     32U
+#define POOL_SESSION_COUNT    24U
+/* The transport's TX path no longer goes through canardTxPush (see tx_transfer_queue.hpp);
+ * TX items only back the bench's synthetic frame streams. */
+#define POOL_TX_ITEM_SIZE     POOL_ALIGN(sizeof(struct CanardTxQueueItem))
+#define POOL_TX_ITEM_COUNT    8U
+#define POOL_PAYLOAD_SIZE     CANARD_MTU_CAN_FD
+#define POOL_PAYLOAD_COUNT    32U
+/* One block per multi-frame transfer being reassembled at the same time. */
+#define POOL_REASSEMBLY_SIZE  POOL_ALIGN(APP_MEMORY_REASSEMBLY_SIZE)
+#define POOL_REASSEMBLY_COUNT 4U
+
+typedef struct PoolBlock {
+    struct PoolBlock* next;
+} PoolBlock;
+
+typedef struct {
+    uint8_t*   begin;
+    uint8_t*   end;
+    PoolBlock* free_list;
+} Pool;
+
+static uint64_t s_session_storage[POOL_SESSION_COUNT * POOL_SESSION_SIZE / sizeof(uint64_t)];
+static uint64_t s_tx_item_storage[POOL_TX_ITEM_COUNT * POOL_TX_ITEM_SIZE / sizeof(uint64_t)];
+static uint64_t s_payload_storage[POOL_PAYLOAD_COUNT * POOL_PAYLOAD_SIZE / sizeof(uint64_t)];
+static uint64_t s_reassembly_storage[POOL_REASSEMBLY_COUNT * POOL_REASSEMBLY_SIZE / sizeof(uint64_t)];
+
+static Pool s_pools[APP_MEMORY_POOL_CLASS_COUNT];
+
+static void pool_init(enum AppMemoryPoolClass cls, void* storage, size_t block_size, uint16_t count)
+{
+    Pool* p = &s_pools[cls];
+    p->begin     = (uint8_t*)storage;
+    p->end       = p->begin + (block_size * count);
+    p->free_list = NULL;
+    for (uint16_t i = count; i > 0U; i--) {
+        PoolBlock* b = (PoolBlock*)(p->begin + (block_size * (i - 1U)));
+        b->next      = p->free_list;
+        p->free_list = b;
+    }
+    s_stats.pools[cls].block_size  = block_size;
+    s_stats.pools[cls].block_count = count;
+}
+
+static void pools_init(void)
+{
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+    pool_init(APP_MEMORY_POOL_SESSION, s_session_storage, POOL_SESSION_SIZE, POOL_SESSION_COUNT);
+    pool_init(APP_MEMORY_POOL_TX_ITEM, s_tx_item_storage, POOL_TX_ITEM_SIZE, POOL_TX_ITEM_COUNT);
+    pool_init(APP_MEMORY_POOL_PAYLOAD, s_payload_storage, POOL_PAYLOAD_SIZE, POOL_PAYLOAD_COUNT);
+    pool_init(APP_MEMORY_POOL_REASSEMBLY, s_reassembly_storage, POOL_REASSEMBLY_SIZE, POOL_REASSEMBLY_COUNT);
+}
+
+static void* canard_allocate(void* const user_reference, const size_t size)
+{
+    (void)user_reference;
+    if (size == 0U) {
+        return NULL;
+    }
+    /* Smallest class that fits; spill into the smallest larger class with a free block
+     * when it is exhausted. (The TX item size is platform dependent, so no fixed order.) */
+    int best  = -1;
+    int taken = -1;
+    for (int c = 0; c < (int)APP_MEMORY_POOL_CLASS_COUNT; c++) {
+        const size_t block_size = s_stats.pools[c].block_size;
+        if (size > block_size) {
+            continue;
+        }
+        if (best < 0 || block_size < s_stats.pools[best].block_size) {
+            best = c;
+        }
+        if (s_pools[c].free_list != NULL &&
+            (taken < 0 || block_size < s_stats.pools[taken].block_size)) {
+            taken = c;
+        }
+    }
+    if (taken < 0) {
+        if (best >= 0) {
+            s_stats.pools[best].alloc_failures++;
+        }
+        s_stats.failures++;
+        return NULL;
+    }
+    PoolBlock* const b = s_pools[taken].free_list;
+    s_pools[taken].free_list = b->next;
+    AppMemoryPoolStats* const st = &s_stats.pools[taken];
+    st->in_use++;
+    if (st->in_use > st->peak_in_use) {
+        st->peak_in_use = st->in_use;
+    }
+    s_stats.allocations++;
+    return b;
+}
+
+static void canard_deallocate(void* const user_reference, const size_t size, void* const pointer)
+{
+    (void)user_reference;
+    (void)size;
+    if (pointer == NULL) {
+        return;
+    }
+    /* The owning pool is found from the address, since a block may have spilled into a larger class. */
+    uint8_t* const p = (uint8_t*)pointer;
+    for (int c = 0; c < (int)APP_MEMORY_POOL_CLASS_COUNT; c++) {
+        if (p >= s_pools[c].begin && p < s_pools[c].end) {
+            PoolBlock* b = (PoolBlock*)pointer;
+            b->next = s_pools[c].free_list;
+            s_pools[c].free_list = b;
+            s_stats.pools[c].in_use--;
+            s_stats.deallocations++;
+            return;
+        }
+    }
+}
+
+#else /* APP_MEMORY_BACKEND_HEAP4 */
+
+static void pools_init(void)
+{
+}
 
 static void* canard_allocate(void* const user_reference, const size_t size)
 {
@@ -13,7 +146,13 @@ static void* canard_allocate(void* const user_reference, const size_t size)
     if (size == 0U) {
         return NULL;
     }
-    return pvPortMalloc(size);
+    void* const p = pvPortMalloc(size);
+    if (p != NULL) {
+        s_stats.allocations++;
+    } else {
+        s_stats.failures++;
+    }
+    return p;
 }
 
 static void canard_deallocate(void* const user_reference, const size_t size, void* const pointer)
@@ -21,12 +160,16 @@ static void canard_deallocate(void* const user_reference, const size_t size, voi
     (void)user_reference;
     (void)size;
     if (pointer != NULL) {
+        s_stats.deallocations++;
         vPortFree(pointer);
     }
 }
 
+#endif /* APP_MEMORY_BACKEND */
+
 struct CanardMemoryResource app_memory_canard_resource(void)
 {
+    pools_init();
     struct CanardMemoryResource r = {
         .user_reference = NULL,
         .deallocate     = canard_deallocate,
@@ -34,3 +177,10 @@ struct CanardMemoryResource app_memory_canard_resource(void)
     };
     return r;
 }
+
+void app_memory_get_stats(AppMemoryStats* out)
+{
+    if (out != NULL) {
+        memcpy(out, &s_stats, sizeof(*out));
+    }
+}
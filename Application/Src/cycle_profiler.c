@@ -0,0 +1,40 @@
+/**
+ * @file cycle_profiler.c
+ * @brief Per-region cycle statistics on DWT CYCCNT (only built into USAGI_PROFILE builds).
+ */
+
+#include "cycle_profiler.h"
+
+#if USAGI_PROFILE
+
+#include <string.h>
+
+static ProfStats s_stats[PROF_REGION_COUNT];
+
+void prof_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+    memset(s_stats, 0, sizeof(s_stats));
+}
+
+void prof_record(ProfRegion region, uint32_t start)
+{
+    const uint32_t cycles = DWT->CYCCNT - start;
+    ProfStats* const s = &s_stats[region];
+    if (s->count == 0U || cycles < s->min_cycles) {
+        s->min_cycles = cycles;
+    }
+    if (cycles > s->max_cycles) {
+        s->max_cycles = cycles;
+    }
+    s->total_cycles += cycles;
+    s->count++;
+}
+
+void prof_get(ProfRegion region, ProfStats* out)
+{
+    *out = s_stats[region];
+}
+
+#endif /* USAGI_PROFILE */
@@ -0,0 +1,1031 @@
+/**
+ * @file cyphal_bench.cpp
+ * @brief Cyphal RX/TX 経路のベンチマーク本体。プラットフォーム依存部は cyphal_bench.h を参照。
+ *
+ * RX は FDCAN 起動前に inject_rx() でリングへ積み、step()（= process_rx）を計時する。
+ * rx_duplicate は同じ単一フレームを 2 回ずつ積み、ハンドラに 1 回だけ渡ること（transfer-ID の重複検出）と
+ * transfer_id_timeout_usec の境界を確かめる。
+ * rx_fdcan だけは FDCAN 起動後にフレームをバスから受けさせ（cyphal_bench_bus_receive）、
+ * isr_rx の RX FIFO0 読み出し（PROF_RX_READ）も通す。
+ * rx_filter は購読している subject と購読していない subject のフレームを交互にバスから受けさせ、
+ * HW フィルタを通って FIFO から読まれたフレーム（RxStats::frames）が購読分だけであることを確かめる。
+ * 合成ストリームは送信側の canard インスタンス（node-ID 42）で生成するので、
+ * マルチフレームのトグル・CRC も実機のバスと同じ形になる。
+ * TX は publish() から最後のフレームを HW FIFO に積むまでの CPU 時間と経過時間を計る。
+ * tx_priority はバスを 1 フレームずつ進められるとき（ホスト）だけ、低優先度のバルク転送の
+ * 途中で高優先度フレームを積み、それより先にバスへ出たフレーム数と同一 ID の順序崩れを数える
+ * （先に出たフレームが kPriorityMaxFramesAhead 以下で、順序崩れがなければ ok）。
+ * tx_deadline は同じくホストだけ、バスを止めて短い期限（200 µs..2 ms）の転送を TX キューに残し、
+ * step() を回し続けて TxStats::expired が期限から何 µs で増えたかを計る（100 µs 未満で ok）。
+ * tx_deadline_multi は同じことを 3 フレームの転送で行い、expired が転送数で数えられることも確かめる。
+ * crc_sw / crc_hw は 64 バイト（CAN FD 1 フレーム分）の転送 CRC をそれぞれの実装で計る。
+ * tx_framing はローカルの TxTransferQueue が切り出すフレームを、同じ転送を送信側 canard の
+ * canardTxPush で分割したものとバイト単位で比べる（0..500 バイト、送信済み領域の再利用を含む）。
+ * tx_arena は送られない低優先度の転送をアリーナに残したまま高優先度の転送を積み続け、
+ * reserve() が失敗しない（回収が commit 順に縛られない）ことを確かめる。
+ * servo_limiter は servo_trajectory の速度・加速度制限に目標値のステップ（0→0.05, 0→0.3, -1→+1）を与え、
+ * 目標値を越えず、出力の加速度が制限を超えず、目標値に着くことを確かめる。
+ * USAGI_PROFILE のビルドでは最後に PROF_RX_READ / PROF_TX_WRITE の集計を出す
+ * （CYPHAL_FDCAN_FAST_PATH の 0 / 1 で比べる）。
+ */
+
+#include "cyphal_bench.h"
+#include "cyphal_publish.hpp"
+#include "cyphal_transport.hpp"
+#include "app_memory.h"
+#include "cycle_profiler.h"
+#include "mono_clock.h"
+#include "actuator_loop.h"
+#include "servo_trajectory.h"
+#include "transfer_crc.h"
+#include "tx_transfer_queue.hpp"
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <uavcan/node/Heartbeat_1_0.hpp>
+#include <uavcan/primitive/array/Natural32_1_0.hpp>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr CanardPortID kRxSubjectSingle = 7000;
+constexpr CanardPortID kRxSubjectMulti  = 7001;
+constexpr CanardPortID kTxSubjectMulti  = 7101;  /* 購読しない（ループバックを HW フィルタで落とす） */
+constexpr CanardNodeID kRemoteNodeId    = 42;
+constexpr CanardNodeID kDuplicateNodeId = 43;    /* rx_duplicate の送信元（他シナリオのセッションと分ける） */
+constexpr size_t       kRxExtent        = 256;   /* マルチフレームの再構成は extent 分を確保する */
+constexpr size_t       kMultiPayload    = 200;   /* CAN FD で 4 フレーム */
+constexpr size_t       kBurst           = 16;    /* RX リングの段数 */
+constexpr uint32_t     kIterations      = 2000;
+constexpr size_t       kMaxStreamFrames = 8;
+constexpr uint32_t     kPriorityIterations = 500;
+constexpr CanardMicrosecond kPriorityDeadlineUsec = 1000U * 1000U;
+/* 高優先度フレームより先にバスへ出てよいフレーム数。tx_priority はバスを止めたホストでだけ走り、
+ * そこでは HW バッファに残ったバルクのフレームも CAN ID の調停で負けるので 0。 */
+constexpr uint32_t     kPriorityMaxFramesAhead = 0;
+constexpr size_t       kFramingMaxPayload = 500;  /* canard 側が kMaxStreamFrames に収まる最大に近い長さ */
+constexpr uint32_t     kFramingTransfers  = 3U * (kFramingMaxPayload + 1U);
+constexpr size_t       kFramingDepth      = 4;    /* TxTransferQueue に同時に積んでおく転送数の上限 */
+constexpr size_t       kArenaParkedPayload = 500;  /* tx_arena で送らずに置いておく Optional の転送 */
+constexpr size_t       kArenaMaxPayload    = 300;
+constexpr float        kServoMaxVelocity     = 4.0f;   /* servo_trajectory の既定値 */
+constexpr float        kServoMaxAcceleration = 40.0f;
+constexpr uint32_t     kServoMaxSteps        = 100;    /* 2 s */
+constexpr float        kServoOvershootTolerance    = 1e-6f;   /* float の丸め分 */
+constexpr float        kServoAccelerationTolerance = 1.001f;
+constexpr CanardPortID kTxSubjectDeadline = 7102;  /* 購読しない */
+constexpr uint32_t     kDeadlineUsec[] = {200, 500, 1000, 2000};  /* tx_deadline の期限 */
+constexpr size_t       kDeadlineCount  = sizeof(kDeadlineUsec) / sizeof(kDeadlineUsec[0]);
+constexpr uint32_t     kDeadlineToleranceUsec = 100;  /* 期限切れの検出の遅れの許容（tick 時刻なら 10 ms） */
+constexpr CanardMicrosecond kDeadlineGiveUpUsec = 20U * 1000U;
+
+static_assert(kRxExtent <= APP_MEMORY_REASSEMBLY_SIZE, "rx_multi needs a reassembly block for kRxExtent");
+
+struct Stream {
+    CyphalBenchFrame frames[kMaxStreamFrames];
+    size_t           count;
+};
+
+struct Result {
+    uint32_t transfers;
+    uint32_t frames;
+    uint64_t cycles;              /* 計時区間の合計 */
+    uint32_t max_latency_cycles;
+    uint32_t allocations;
+    uint32_t alloc_failures;
+};
+
+/** tx_priority の結果。 */
+struct PriorityResult {
+    uint32_t transfers;           /* 高優先度の転送数 */
+    uint32_t frames;              /* バスに出た全フレーム数 */
+    uint32_t max_frames_ahead;    /* 高優先度フレームを積んでから先に出たフレーム数の最大 */
+    uint32_t reordered;           /* バルク転送のテールバイト（toggle / transfer-ID）の順序崩れ */
+};
+
+/** 同じ subject のフレーム列がテールバイトの上で積んだ順に並んでいるかを追う。 */
+struct OrderCheck {
+    bool    started;
+    bool    in_transfer;
+    bool    toggle;
+    uint8_t tid;
+};
+
+Stream s_single;
+Stream s_multi;
+
+const CyphalBenchFrame* s_recording       = nullptr;
+size_t                  s_recording_count = 0;
+
+uint32_t s_rx_stamp;  /* 最後にハンドラが呼ばれた時点の CYCCNT */
+uint32_t s_rx_count;  /* ハンドラが呼ばれた回数 */
+
+void on_rx(const CanardRxTransfer& transfer, void* context)
+{
+    (void)transfer;
+    (void)context;
+    s_rx_stamp = DWT->CYCCNT;
+    s_rx_count++;
+}
+
+/** 送信側 canard（node-ID 42）で subject 宛ての転送を 1 つフレーム化する。 */
+bool canard_frames(CanardPortID subject_id, CanardTransferID transfer_id,
+                   const uint8_t* payload, size_t payload_size, Stream& out)
+{
+    const CanardMemoryResource mem = app_memory_canard_resource();
+    CanardInstance remote = canardInit(mem);
+    remote.node_id        = kRemoteNodeId;
+    CanardTxQueue queue   = canardTxInit(kMaxStreamFrames, CANARD_MTU_CAN_FD, mem);
+
+    const CanardTransferMetadata meta = {
+        .priority       = CanardPriorityNominal,
+        .transfer_kind  = CanardTransferKindMessage,
+        .port_id        = subject_id,
+        .remote_node_id = CANARD_NODE_ID_UNSET,
+        .transfer_id    = transfer_id,
+    };
+    const CanardPayload p = { .size = payload_size, .data = payload };
+    if (canardTxPush(&queue, &remote, ~(CanardMicrosecond)0, &meta, p, 0, nullptr) <= 0) return false;
+
+    out.count = 0;
+    while (const CanardTxQueueItem* item = canardTxPeek(&queue)) {
+        CyphalBenchFrame& f = out.frames[out.count++];
+        f.can_id = item->frame.extended_can_id;
+        f.size   = (uint8_t)item->frame.payload.size;
+        std::memcpy(f.data, item->frame.payload.data, f.size);
+        canardTxFree(&queue, &remote, canardTxPop(&queue, const_cast<CanardTxQueueItem*>(item)));
+    }
+    return true;
+}
+
+/** subject 宛ての payload_size バイト（内容は 0, 1, 2, ...）の転送を 1 つフレーム化する。 */
+bool make_stream(CanardPortID subject_id, size_t payload_size, Stream& out)
+{
+    static uint8_t payload[kMultiPayload];
+    for (size_t i = 0; i < payload_size; ++i) payload[i] = (uint8_t)i;
+    return canard_frames(subject_id, 0, payload, payload_size, out);
+}
+
+/** ストリームを 1 転送分リングに積む。テールバイトの transfer-ID を tid に差し替える。 */
+void inject_transfer(const Stream& s, uint8_t tid)
+{
+    auto& transport = CyphalTransport::instance();
+    const CanardMicrosecond now = mono_clock_usec();
+    for (size_t i = 0; i < s.count; ++i) {
+        CyphalBenchFrame f = s.frames[i];
+        f.data[f.size - 1U] = (uint8_t)((f.data[f.size - 1U] & ~31U) | (tid & 31U));
+        (void)transport.inject_rx(f.can_id, f.data, f.size, now);
+    }
+}
+
+/** 送信元と受信時刻を指定して積む（rx_duplicate 用）。 */
+void inject_transfer_from(const Stream& s, CanardNodeID source, uint8_t tid, CanardMicrosecond timestamp_usec)
+{
+    auto& transport = CyphalTransport::instance();
+    for (size_t i = 0; i < s.count; ++i) {
+        CyphalBenchFrame f = s.frames[i];
+        f.can_id = (f.can_id & ~(uint32_t)CANARD_NODE_ID_MAX) | source;
+        f.data[f.size - 1U] = (uint8_t)((f.data[f.size - 1U] & ~31U) | (tid & 31U));
+        (void)transport.inject_rx(f.can_id, f.data, f.size, timestamp_usec);
+    }
+}
+
+void print_result(const char* name, const Result& r)
+{
+    const uint64_t cps      = cyphal_bench_cycles_per_sec();
+    const uint64_t total_ns = (r.cycles * 1000000000ULL) / cps;
+    const uint32_t frames   = (r.frames > 0) ? r.frames : 1U;
+    const uint32_t xfers    = (r.transfers > 0) ? r.transfers : 1U;
+    const uint64_t fps      = (total_ns > 0) ? ((uint64_t)frames * 1000000000ULL) / total_ns : 0U;
+    const uint32_t allocs_milli = (uint32_t)(((uint64_t)r.allocations * 1000U) / xfers);
+    const uint64_t max_latency_ns = ((uint64_t)r.max_latency_cycles * 1000000000ULL) / cps;
+
+    /* newlib-nano は %llu を持たないので unsigned long に収まる値だけ出す */
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"transfers\":%lu,\"frames\":%lu,"
+                "\"ns_per_frame\":%lu,\"frames_per_sec\":%lu,\"allocs_per_transfer\":%lu.%03lu,"
+                "\"alloc_failures\":%lu,\"max_latency_ns\":%lu,\"ok\":%s}\n",
+                name, cyphal_bench_platform(),
+                (unsigned long)r.transfers, (unsigned long)r.frames,
+                (unsigned long)(total_ns / frames), (unsigned long)fps,
+                (unsigned long)(allocs_milli / 1000U), (unsigned long)(allocs_milli % 1000U),
+                (unsigned long)r.alloc_failures, (unsigned long)max_latency_ns,
+                (r.transfers > 0 && r.alloc_failures == 0) ? "true" : "false");
+}
+
+/* ---- RX ---- */
+
+/** 1 step あたり transfers_per_step 転送を積んで step() を計時する。 */
+Result run_rx(const Stream& s, size_t transfers_per_step)
+{
+    auto& transport = CyphalTransport::instance();
+    Result r{};
+    AppMemoryStats m0;
+    app_memory_get_stats(&m0);
+    const CyphalTransport::RxStats rx0 = transport.rx_stats();
+
+    uint8_t tid = 0;
+    for (uint32_t it = 0; it < kIterations; ++it) {
+        for (size_t k = 0; k < transfers_per_step; ++k) inject_transfer(s, tid++);
+        r.frames += (uint32_t)(s.count * transfers_per_step);
+
+        const uint32_t t0 = DWT->CYCCNT;
+        s_rx_stamp = t0;
+        transport.step();
+        const uint32_t t1 = DWT->CYCCNT;
+        r.cycles += t1 - t0;
+        const uint32_t latency = s_rx_stamp - t0;
+        if (latency > r.max_latency_cycles) r.max_latency_cycles = latency;
+    }
+
+    AppMemoryStats m1;
+    app_memory_get_stats(&m1);
+    r.transfers      = transport.rx_stats().transfers - rx0.transfers;
+    r.allocations    = m1.allocations - m0.allocations;
+    r.alloc_failures = m1.failures - m0.failures;
+    return r;
+}
+
+/** ストリームを 1 転送ずつバスから受けさせて step() を計時する。バスから受けられなければ false。 */
+bool run_rx_bus(const Stream& s, Result& r)
+{
+    auto& transport = CyphalTransport::instance();
+    r = Result{};
+    AppMemoryStats m0;
+    app_memory_get_stats(&m0);
+    const CyphalTransport::RxStats rx0 = transport.rx_stats();
+
+    for (uint32_t it = 0; it < kIterations; ++it) {
+        for (size_t i = 0; i < s.count; ++i) {
+            CyphalBenchFrame f = s.frames[i];
+            f.data[f.size - 1U] = (uint8_t)((f.data[f.size - 1U] & ~31U) | (it & 31U));
+            if (!cyphal_bench_bus_receive(&f)) return false;
+        }
+        r.frames += (uint32_t)s.count;
+
+        const uint32_t t0 = DWT->CYCCNT;
+        s_rx_stamp = t0;
+        transport.step();
+        const uint32_t t1 = DWT->CYCCNT;
+        r.cycles += t1 - t0;
+        const uint32_t latency = s_rx_stamp - t0;
+        if (latency > r.max_latency_cycles) r.max_latency_cycles = latency;
+    }
+
+    AppMemoryStats m1;
+    app_memory_get_stats(&m1);
+    r.transfers      = transport.rx_stats().transfers - rx0.transfers;
+    r.allocations    = m1.allocations - m0.allocations;
+    r.alloc_failures = m1.failures - m0.failures;
+    return true;
+}
+
+/** rx_filter の結果。 */
+struct FilterResult {
+    uint32_t subscribed;          /* バスから受けさせた購読 subject のフレーム数 */
+    uint32_t foreign;             /* 同じく購読していない subject のフレーム数 */
+    uint32_t read;                /* isr_rx が FIFO から読んだフレーム数（RxStats::frames の増分） */
+};
+
+/** 購読していない subject（kTxSubjectMulti は送信専用で購読しない） */
+constexpr CanardPortID kForeignSubjects[] = {kTxSubjectMulti, 7002, 0, CANARD_SUBJECT_ID_MAX};
+
+/** 1 フレームの単一フレーム転送を、購読 subject と購読していない subject に送り分ける。 */
+bool run_rx_filter(const Stream& s, FilterResult& r)
+{
+    auto& transport = CyphalTransport::instance();
+    r = FilterResult{};
+    const CyphalTransport::RxStats rx0 = transport.rx_stats();
+
+    for (uint32_t it = 0; it < kPriorityIterations; ++it) {
+        CyphalBenchFrame f = s.frames[0];
+        f.data[f.size - 1U] = (uint8_t)((f.data[f.size - 1U] & ~31U) | (it & 31U));
+        if (!cyphal_bench_bus_receive(&f)) return false;
+        r.subscribed++;
+        transport.step();
+
+        for (CanardPortID subject : kForeignSubjects) {
+            CyphalBenchFrame g = f;
+            g.can_id = (g.can_id & ~((uint32_t)CANARD_SUBJECT_ID_MAX << 8)) | ((uint32_t)subject << 8);
+            (void)cyphal_bench_bus_receive(&g);  /* ホストではフィルタで落ちれば false */
+            r.foreign++;
+        }
+        transport.step();
+    }
+    r.read = transport.rx_stats().frames - rx0.frames;
+    return true;
+}
+
+void print_filter_result(const char* name, const FilterResult& r)
+{
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"hw_filtered\":%s,\"subscribed\":%lu,"
+                "\"foreign\":%lu,\"read\":%lu,\"ok\":%s}\n",
+                name, cyphal_bench_platform(),
+                CyphalTransport::instance().rx_hw_filtered() ? "true" : "false",
+                (unsigned long)r.subscribed, (unsigned long)r.foreign, (unsigned long)r.read,
+                (r.read == r.subscribed) ? "true" : "false");
+}
+
+/** rx_duplicate の結果。 */
+struct DuplicateResult {
+    uint32_t injected;            /* 積んだ転送数（重複を含む） */
+    uint32_t expected;            /* ハンドラに渡るべき転送数 */
+    uint32_t delivered;           /* 実際にハンドラに渡った転送数 */
+    uint32_t duplicates;          /* RxStats::duplicates の増分（単一フレーム経路のときだけ数える） */
+};
+
+/**
+ * 1 ms 間隔の転送を 1 µs 後の重複つきで積む。最後に同じ transfer-ID を前回から
+ * transfer_id_timeout_usec ちょうど（重複）と、その 1 µs 後（新しい転送）に積む。
+ * 受信時刻は inject_rx に渡す値なので、実時間は待たない。
+ */
+DuplicateResult run_rx_duplicate(const Stream& s)
+{
+    auto& transport = CyphalTransport::instance();
+    DuplicateResult r{};
+    const CyphalTransport::RxStats rx0 = transport.rx_stats();
+    const uint32_t count0 = s_rx_count;
+
+    CanardMicrosecond t   = mono_clock_usec();
+    uint8_t           tid = 0;
+    for (uint32_t it = 0; it < kIterations; ++it) {
+        inject_transfer_from(s, kDuplicateNodeId, tid, t);
+        inject_transfer_from(s, kDuplicateNodeId, tid, t + 1U);
+        transport.step();
+        r.injected += 2;
+        r.expected += 1;
+        tid = (uint8_t)((tid + 1U) & CANARD_TRANSFER_ID_MAX);
+        t += 1000U;
+    }
+
+    const CanardMicrosecond at[] = {
+        t,
+        t + CANARD_DEFAULT_TRANSFER_ID_TIMEOUT_USEC,
+        t + CANARD_DEFAULT_TRANSFER_ID_TIMEOUT_USEC + 1U,
+    };
+    for (CanardMicrosecond ts : at) {
+        inject_transfer_from(s, kDuplicateNodeId, tid, ts);
+        transport.step();
+        r.injected++;
+    }
+    r.expected += 2;
+
+    r.delivered  = s_rx_count - count0;
+    r.duplicates = transport.rx_stats().duplicates - rx0.duplicates;
+    return r;
+}
+
+void print_duplicate_result(const char* name, const DuplicateResult& r)
+{
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"injected\":%lu,\"expected\":%lu,"
+                "\"delivered\":%lu,\"duplicates\":%lu,\"ok\":%s}\n",
+                name, cyphal_bench_platform(),
+                (unsigned long)r.injected, (unsigned long)r.expected,
+                (unsigned long)r.delivered, (unsigned long)r.duplicates,
+                (r.delivered == r.expected) ? "true" : "false");
+}
+
+/** 記録済みストリームをリングが満杯になるまで積んでは step() する。 */
+Result run_rx_replay()
+{
+    auto& transport = CyphalTransport::instance();
+    Result r{};
+    AppMemoryStats m0;
+    app_memory_get_stats(&m0);
+    const CyphalTransport::RxStats rx0 = transport.rx_stats();
+
+    size_t i = 0;
+    while (i < s_recording_count) {
+        const CanardMicrosecond now = mono_clock_usec();
+        while (i < s_recording_count) {
+            const CyphalBenchFrame& f = s_recording[i];
+            if (!transport.inject_rx(f.can_id, f.data, f.size, now)) break;
+            ++i;
+            ++r.frames;
+        }
+        const uint32_t t0 = DWT->CYCCNT;
+        transport.step();
+        const uint32_t cycles = DWT->CYCCNT - t0;
+        r.cycles += cycles;
+        if (cycles > r.max_latency_cycles) r.max_latency_cycles = cycles;
+    }
+
+    AppMemoryStats m1;
+    app_memory_get_stats(&m1);
+    r.transfers      = transport.rx_stats().transfers - rx0.transfers;
+    r.allocations    = m1.allocations - m0.allocations;
+    r.alloc_failures = m1.failures - m0.failures;
+    return r;
+}
+
+/* ---- TX ---- */
+
+/**
+ * HW FIFO に収まらなかった TX キューの残りを、空いた分だけ step() で積み直す。
+ * wait_bus なら HW が最後のフレームを送り終えるまで待つ。戻り値は step() の CPU 時間（待ち時間は入れない）。
+ */
+uint32_t drain_tx(bool wait_bus)
+{
+    auto& transport = CyphalTransport::instance();
+    uint32_t cycles = 0;
+    while (transport.tx_pending() > 0) {
+        (void)cyphal_bench_service_tx();
+        const uint32_t s = DWT->CYCCNT;
+        transport.step();
+        cycles += DWT->CYCCNT - s;
+    }
+    if (wait_bus) {
+        while (!cyphal_bench_service_tx()) {
+        }
+    }
+    return cycles;
+}
+
+template<typename T>
+Result run_tx(CanardPortID subject_id, const T& msg)
+{
+    auto& transport = CyphalTransport::instance();
+    Result r{};
+    AppMemoryStats m0;
+    app_memory_get_stats(&m0);
+    const uint32_t frames0 = transport.tx_stats().frames;
+
+    CanardTransferID tid = 0;
+    for (uint32_t it = 0; it < kIterations; ++it) {
+        const uint32_t t0 = DWT->CYCCNT;
+        const bool ok = cyphal::publish(subject_id, tid, msg);
+        transport.step();
+        uint32_t busy = DWT->CYCCNT - t0;
+        busy += drain_tx(false);
+        const uint32_t latency = DWT->CYCCNT - t0;
+        (void)drain_tx(true);
+        if (ok) r.transfers++;
+        r.cycles += busy;
+        if (latency > r.max_latency_cycles) r.max_latency_cycles = latency;
+    }
+
+    AppMemoryStats m1;
+    app_memory_get_stats(&m1);
+    r.frames         = transport.tx_stats().frames - frames0;
+    r.allocations    = m1.allocations - m0.allocations;
+    r.alloc_failures = m1.failures - m0.failures;
+    return r;
+}
+
+/* ---- TX priority ---- */
+
+CanardPortID subject_of(uint32_t can_id)
+{
+    return (CanardPortID)((can_id >> 8) & CANARD_SUBJECT_ID_MAX);
+}
+
+bool in_order(OrderCheck& c, const CyphalBenchFrame& f)
+{
+    const uint8_t tail   = f.data[f.size - 1U];
+    const bool    sot    = (tail & 0x80U) != 0U;
+    const bool    eot    = (tail & 0x40U) != 0U;
+    const bool    toggle = (tail & 0x20U) != 0U;
+    const uint8_t tid    = tail & 31U;
+    const bool ok = sot ? (!c.in_transfer && toggle && (!c.started || tid == ((c.tid + 1U) & 31U)))
+                        : (c.in_transfer && tid == c.tid && toggle != c.toggle);
+    c.started     = true;
+    c.in_transfer = !eot;
+    c.toggle      = toggle;
+    c.tid         = tid;
+    return ok;
+}
+
+/** バスに 1 フレーム出し、TX 完了割り込みの代わりに step() で HW を再充填する。 */
+bool bus_step(OrderCheck& check, PriorityResult& r, CyphalBenchFrame& f)
+{
+    if (!cyphal_bench_bus_transmit(&f)) return false;
+    r.frames++;
+    if (subject_of(f.can_id) == kTxSubjectMulti && !in_order(check, f)) r.reordered++;
+    CyphalTransport::instance().step();
+    return true;
+}
+
+/** バスを 1 フレームずつ進められないプラットフォームでは false（結果なし）。 */
+template<typename Bulk, typename Urgent>
+bool run_tx_priority(const Bulk& bulk, CanardPortID urgent_subject, const Urgent& urgent,
+                     PriorityResult& r)
+{
+    auto& transport = CyphalTransport::instance();
+    r = PriorityResult{};
+    OrderCheck check{};
+    CyphalBenchFrame f;
+    CanardTransferID bulk_tid   = 0;
+    CanardTransferID urgent_tid = 0;
+
+    for (uint32_t it = 0; it < kPriorityIterations; ++it) {
+        /* バルク 2 転送（同じ CAN ID が 6 フレーム）を積み、1..3 フレームだけ先に流しておく */
+        for (int k = 0; k < 2; ++k) {
+            (void)cyphal::publish(kTxSubjectMulti, bulk_tid, bulk,
+                                  {CanardPriorityLow, kPriorityDeadlineUsec});
+        }
+        transport.step();
+        for (uint32_t k = 0; k < 1U + it % 3U; ++k) {
+            if (!bus_step(check, r, f)) {
+                /* 実機: HW が自分で送出しているので、残りを流して終わる */
+                (void)drain_tx(true);
+                return false;
+            }
+        }
+
+        if (cyphal::publish(urgent_subject, urgent_tid, urgent,
+                            {CanardPriorityFast, kPriorityDeadlineUsec})) {
+            r.transfers++;
+        }
+        transport.step();
+        uint32_t ahead = 0;
+        while (bus_step(check, r, f) && subject_of(f.can_id) != urgent_subject) {
+            ahead++;
+        }
+        if (ahead > r.max_frames_ahead) r.max_frames_ahead = ahead;
+
+        while (bus_step(check, r, f)) {
+        }
+    }
+    return true;
+}
+
+void print_priority_result(const char* name, const PriorityResult& r)
+{
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"transfers\":%lu,\"frames\":%lu,"
+                "\"max_frames_ahead\":%lu,\"reordered\":%lu,\"ok\":%s}\n",
+                name, cyphal_bench_platform(),
+                (unsigned long)r.transfers, (unsigned long)r.frames,
+                (unsigned long)r.max_frames_ahead, (unsigned long)r.reordered,
+                (r.transfers > 0 && r.max_frames_ahead <= kPriorityMaxFramesAhead && r.reordered == 0)
+                    ? "true" : "false");
+}
+
+/* ---- TX deadline ---- */
+
+/** tx_deadline の結果。遅れは期限から、期限切れを検出した step() の直後までの時間。 */
+struct DeadlineResult {
+    uint32_t transfers;           /* 期限付きで積んだ転送数 */
+    uint32_t expired;             /* TxStats::expired の増分 */
+    uint32_t early;               /* 期限前に捨てられた転送数 */
+    uint32_t missed;              /* 期限 + kDeadlineGiveUpUsec までに捨てられなかった転送数 */
+    uint32_t max_late_usec;
+    uint64_t total_late_usec;
+};
+
+uint32_t tx_expired_total()
+{
+    uint32_t n = 0;
+    for (uint32_t e : CyphalTransport::instance().tx_stats().expired) n += e;
+    return n;
+}
+
+/**
+ * 同じ CAN ID の単一フレーム（blocker）を HW に 1 つ送信待ちで残し（バスを止めておく）、
+ * 後ろに短い期限の転送 msg を積む。msg がマルチフレームでも expired は 1 転送で 1 増える。
+ * 期限の前後で step() を回し続け、TxStats::expired が増えた時刻と期限の差を取る。
+ * バスを止めておけないプラットフォームでは false（結果なし）。
+ */
+template<typename Blocker, typename T>
+bool run_tx_deadline(CanardPortID subject_id, const Blocker& blocker, const T& msg, DeadlineResult& r)
+{
+    auto& transport = CyphalTransport::instance();
+    r = DeadlineResult{};
+    CyphalBenchFrame f;
+    CanardTransferID tid = 0;
+
+    for (uint32_t it = 0; it < kPriorityIterations; ++it) {
+        const uint32_t deadline = kDeadlineUsec[it % kDeadlineCount];
+        (void)cyphal::publish(subject_id, tid, blocker, {CanardPriorityNominal, kPriorityDeadlineUsec});
+        transport.step();
+
+        const uint32_t expired0 = tx_expired_total();
+        const CanardMicrosecond t0 = mono_clock_usec();  /* commit() の時刻以前なので期限はこれ + deadline 以降 */
+        const bool queued = cyphal::publish(subject_id, tid, msg, {CanardPriorityNominal, deadline});
+        if (queued) r.transfers++;
+        const CanardMicrosecond due = t0 + deadline;
+
+        CanardMicrosecond now = t0;
+        while (queued) {
+            transport.step();
+            now = mono_clock_usec();
+            if (tx_expired_total() != expired0) break;
+            if (now > due + kDeadlineGiveUpUsec) {
+                r.missed++;
+                break;
+            }
+        }
+        const uint32_t expired = tx_expired_total() - expired0;
+        r.expired += expired;
+        if (expired > 0) {
+            if (now <= due) {
+                r.early++;
+            } else {
+                const uint32_t late = (uint32_t)(now - due);
+                r.total_late_usec += late;
+                if (late > r.max_late_usec) r.max_late_usec = late;
+            }
+        }
+
+        /* 止めておいたフレームを流す。実機では HW が自分で送出しているので測れていない */
+        if (!cyphal_bench_bus_transmit(&f)) {
+            (void)drain_tx(true);
+            return false;
+        }
+        transport.step();
+        while (cyphal_bench_bus_transmit(&f)) {
+            transport.step();
+        }
+    }
+    return true;
+}
+
+void print_deadline_result(const char* name, const DeadlineResult& r)
+{
+    const bool ok = r.transfers > 0 && r.expired == r.transfers && r.early == 0 && r.missed == 0 &&
+                    r.max_late_usec < kDeadlineToleranceUsec;
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"transfers\":%lu,\"expired\":%lu,"
+                "\"early\":%lu,\"missed\":%lu,\"mean_late_usec\":%lu,\"max_late_usec\":%lu,\"ok\":%s}\n",
+                name, cyphal_bench_platform(),
+                (unsigned long)r.transfers, (unsigned long)r.expired,
+                (unsigned long)r.early, (unsigned long)r.missed,
+                (unsigned long)((r.expired > 0) ? r.total_late_usec / r.expired : 0U),
+                (unsigned long)r.max_late_usec, ok ? "true" : "false");
+}
+
+/* ---- CRC ---- */
+
+using CrcFn = uint16_t (*)(uint16_t crc, const void* data, size_t size);
+
+/** 64 バイトずつ CRC を続けて畳み込み、1 フレームあたりのサイクル数を出す。 */
+void run_crc(const char* name, CrcFn fn)
+{
+    static uint8_t frame[CANARD_MTU_CAN_FD];
+    for (size_t i = 0; i < sizeof(frame); ++i) frame[i] = (uint8_t)(i * 7U + 1U);
+
+    uint16_t crc = TRANSFER_CRC_INITIAL;
+    const uint32_t t0 = DWT->CYCCNT;
+    for (uint32_t it = 0; it < kIterations; ++it) {
+        crc = fn(crc, frame, sizeof(frame));
+    }
+    const uint32_t cycles = DWT->CYCCNT - t0;
+
+    /* 既知の検査値（"123456789" → 0x29B1）で実装の取り違えを拾う */
+    const bool ok = fn(TRANSFER_CRC_INITIAL, "123456789", 9) == 0x29B1U;
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"frames\":%lu,\"cycles_per_frame\":%lu,"
+                "\"crc\":%lu,\"check\":%s}\n",
+                name, cyphal_bench_platform(), (unsigned long)kIterations,
+                (unsigned long)(cycles / kIterations), (unsigned long)crc, ok ? "true" : "false");
+}
+
+/* ---- TX framing ---- */
+
+/** tx_framing の結果。 */
+struct FramingResult {
+    uint32_t transfers;
+    uint32_t frames;
+    uint32_t reused;              /* reserve() が送信待ちの転送より前の空きを再利用した回数 */
+    uint32_t mismatches;          /* canard と CAN ID・長さ・内容のどれかが違ったフレーム数 */
+};
+
+/** tx_framing の検査状態。キューには送信順（同じ優先度なので commit 順）に積んである。 */
+struct FramingCheck {
+    TxTransferQueue queue;
+    struct Pending {
+        uint16_t         size;
+        CanardTransferID transfer_id;
+    } pending[kFramingDepth];
+    size_t pending_head;
+    size_t pending_count;
+    Stream expected;              /* 先頭の転送を canard で分割したもの */
+    size_t expected_next;         /* 0 なら先頭の転送はまだ 1 フレームも出していない */
+};
+
+void framing_payload(uint8_t* out, size_t size, CanardTransferID transfer_id)
+{
+    for (size_t i = 0; i < size; ++i) out[i] = (uint8_t)(i * 31U + size + transfer_id);
+}
+
+bool frame_matches(const TxTransferQueue::Frame& f, const CyphalBenchFrame& e)
+{
+    if (f.can_id != e.can_id || f.size != e.size) return false;
+    uint8_t data[CANARD_MTU_CAN_FD] = {};
+    if (f.payload_size > 0U) std::memcpy(data, f.payload, f.payload_size);
+    std::memcpy(&data[f.size - f.trailer_size], f.trailer, f.trailer_size);
+    return std::memcmp(data, e.data, f.size) == 0;
+}
+
+/** キューの先頭から 1 フレーム出して canard の出力と比べる。キューが空なら false。 */
+bool framing_drain_frame(FramingCheck& c, FramingResult& r)
+{
+    TxTransferQueue::Transfer* const t = c.queue.front();
+    if (t == nullptr) return false;
+
+    if (c.expected_next == 0U) {
+        static uint8_t payload[kFramingMaxPayload];
+        const FramingCheck::Pending& p = c.pending[c.pending_head];
+        framing_payload(payload, p.size, p.transfer_id);
+        if (!canard_frames(kTxSubjectMulti, p.transfer_id, payload, p.size, c.expected)) {
+            c.expected.count = 0;
+        }
+    }
+
+    const TxTransferQueue::Frame f = c.queue.next_frame(*t);
+    if (c.expected_next >= c.expected.count || !frame_matches(f, c.expected.frames[c.expected_next])) {
+        r.mismatches++;
+    }
+    c.expected_next++;
+    r.frames++;
+
+    if (c.queue.advance(*t)) {
+        /* canard の方がフレームが多ければ、足りない分も不一致に数える */
+        if (c.expected_next < c.expected.count) r.mismatches += (uint32_t)(c.expected.count - c.expected_next);
+        c.expected_next = 0;
+        c.pending_head  = (c.pending_head + 1U) % kFramingDepth;
+        c.pending_count--;
+    }
+    return true;
+}
+
+/**
+ * 長さを 0..kFramingMaxPayload で回しながら転送を積み、毎回 1..3 フレームだけ流す。
+ * アリーナや kFramingDepth が埋まったら空くまで流すので、予約は送信済みになった前方の空きを使い回す。
+ */
+FramingResult run_tx_framing()
+{
+    static FramingCheck c;
+    c.queue.init();
+    c.pending_head  = 0;
+    c.pending_count = 0;
+    c.expected_next = 0;
+
+    FramingResult r{};
+    const uint32_t can_id = ((uint32_t)CanardPriorityNominal << 26) | (3UL << 21) |
+                            ((uint32_t)kTxSubjectMulti << 8) | kRemoteNodeId;
+    const uint8_t* last = nullptr;
+
+    for (uint32_t i = 0; i < kFramingTransfers; ++i) {
+        /* 隣り合う転送の長さがばらけるように 0..kFramingMaxPayload を飛び飛びに回る */
+        const size_t           size        = (i * 97U) % (kFramingMaxPayload + 1U);
+        const CanardTransferID transfer_id = i & CANARD_TRANSFER_ID_MAX;
+
+        uint8_t* buf = nullptr;
+        while (c.pending_count == kFramingDepth || (buf = c.queue.reserve(size)) == nullptr) {
+            if (!framing_drain_frame(c, r)) break;
+        }
+        if (buf == nullptr) {
+            r.mismatches++;  /* 空のアリーナに収まらない（起きないはず） */
+            continue;
+        }
+        /* キューが空になって先頭に戻ったのは再利用に数えない */
+        if (c.pending_count > 0U && buf < last) r.reused++;
+        last = buf;
+
+        framing_payload(buf, size, transfer_id);
+        (void)c.queue.commit(can_id, transfer_id, size, 0, ~(CanardMicrosecond)0);
+        c.pending[(c.pending_head + c.pending_count) % kFramingDepth] = {(uint16_t)size, transfer_id};
+        c.pending_count++;
+        r.transfers++;
+
+        for (uint32_t k = 0; k < 1U + i % 3U; ++k) {
+            if (!framing_drain_frame(c, r)) break;
+        }
+    }
+    while (framing_drain_frame(c, r)) {
+    }
+    return r;
+}
+
+void print_framing_result(const char* name, const FramingResult& r)
+{
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"transfers\":%lu,\"frames\":%lu,"
+                "\"reused\":%lu,\"mismatches\":%lu}\n",
+                name, cyphal_bench_platform(),
+                (unsigned long)r.transfers, (unsigned long)r.frames,
+                (unsigned long)r.reused, (unsigned long)r.mismatches);
+}
+
+/* ---- TX arena ---- */
+
+/** tx_arena の結果。 */
+struct ArenaResult {
+    uint32_t transfers;           /* 積んだ Nominal の転送数 */
+    uint32_t queue_full;          /* reserve() が失敗した回数 */
+};
+
+/**
+ * ローカルの TxTransferQueue の先頭に送られない Optional の転送を 1 つ置いたまま、
+ * Nominal の転送を積んでは送り切る。Optional の後ろで送信済みになった領域が
+ * 再利用されなければ（commit 順にしか回収しなければ）、アリーナを一周したところで積めなくなる。
+ */
+ArenaResult run_tx_arena()
+{
+    static TxTransferQueue q;
+    q.init();
+    ArenaResult r{};
+    const uint32_t id = (3UL << 21) | ((uint32_t)kTxSubjectMulti << 8) | kRemoteNodeId;
+
+    if (q.reserve(kArenaParkedPayload) == nullptr ||
+        !q.commit(((uint32_t)CanardPriorityOptional << 26) | id, 0, kArenaParkedPayload, 0,
+                  ~(CanardMicrosecond)0)) {
+        r.queue_full++;
+        return r;
+    }
+    for (uint32_t it = 0; it < kIterations; ++it) {
+        const size_t size = 1U + (it * 37U) % kArenaMaxPayload;
+        if (q.reserve(size) == nullptr) {
+            r.queue_full++;
+            continue;
+        }
+        (void)q.commit(((uint32_t)CanardPriorityNominal << 26) | id, it & CANARD_TRANSFER_ID_MAX, size, 0,
+                       ~(CanardMicrosecond)0);
+        r.transfers++;
+        /* Optional は優先度が低いので最後まで先頭に来ない */
+        while (TxTransferQueue::Transfer* t = q.front()) {
+            if (((t->can_id >> 26) & 7U) != (uint32_t)CanardPriorityNominal) break;
+            (void)q.next_frame(*t);
+            (void)q.advance(*t);
+        }
+    }
+    return r;
+}
+
+void print_arena_result(const char* name, const ArenaResult& r)
+{
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"transfers\":%lu,\"queue_full\":%lu,"
+                "\"ok\":%s}\n",
+                name, cyphal_bench_platform(), (unsigned long)r.transfers, (unsigned long)r.queue_full,
+                (r.transfers == kIterations && r.queue_full == 0) ? "true" : "false");
+}
+
+/* ---- Servo limiter ---- */
+
+/** servo_limiter の 1 ケース（-1..1 の単位）。 */
+struct ServoCase {
+    float from;
+    float to;
+};
+
+constexpr ServoCase kServoCases[] = {{0.0f, 0.05f}, {0.0f, 0.3f}, {-1.0f, 1.0f}};
+
+/** servo_limiter の結果。出力は printf の都合で整数に直す。 */
+struct ServoResult {
+    uint32_t settle_steps;        /* 目標値にちょうど着くまでの周期数（着かなければ kServoMaxSteps） */
+    float    overshoot;           /* 目標値を越えた量の最大 */
+    float    max_acceleration;    /* 出力の 2 階差分から求めた加速度の最大 [1/s²] */
+};
+
+/**
+ * 既定の速度・加速度制限で、補間なし（SERVO_TRAJ_STEP）の目標値ステップを from → to で与える。
+ * from へは先に静止させておく。周期は ActuatorTask と同じ ACTUATOR_LOOP_PERIOD_USEC。
+ */
+ServoResult run_servo_limiter(const ServoCase& k)
+{
+    const ServoTrajConfig cfg = {SERVO_TRAJ_STEP, kServoMaxVelocity, kServoMaxAcceleration};
+    constexpr float dt = (float)ACTUATOR_LOOP_PERIOD_USEC / 1e6f;
+    float    out[SERVO_TRAJ_CHANNELS];
+    uint64_t now = ACTUATOR_LOOP_PERIOD_USEC;
+
+    servo_trajectory_init();
+    servo_trajectory_configure(0, &cfg);
+    servo_trajectory_step(now, out);
+    servo_trajectory_set_target(0, k.from, now);
+    for (uint32_t i = 0; i < kServoMaxSteps; ++i) {
+        now += ACTUATOR_LOOP_PERIOD_USEC;
+        servo_trajectory_step(now, out);
+    }
+
+    ServoResult r{kServoMaxSteps, 0.0f, 0.0f};
+    const float direction = (k.to > k.from) ? 1.0f : -1.0f;
+    float pos = out[0];
+    float vel = 0.0f;
+    servo_trajectory_set_target(0, k.to, now);
+    for (uint32_t i = 1; i <= kServoMaxSteps; ++i) {
+        now += ACTUATOR_LOOP_PERIOD_USEC;
+        servo_trajectory_step(now, out);
+        const float v   = (out[0] - pos) / dt;
+        const float acc = (v > vel) ? (v - vel) / dt : (vel - v) / dt;
+        if (acc > r.max_acceleration) r.max_acceleration = acc;
+        const float over = (out[0] - k.to) * direction;
+        if (over > r.overshoot) r.overshoot = over;
+        if (r.settle_steps == kServoMaxSteps && out[0] == k.to) r.settle_steps = i;
+        pos = out[0];
+        vel = v;
+    }
+    return r;
+}
+
+void print_servo_result(const char* name, const ServoCase& k, const ServoResult& r)
+{
+    const bool ok = r.settle_steps < kServoMaxSteps && r.overshoot <= kServoOvershootTolerance &&
+                    r.max_acceleration <= kServoMaxAcceleration * kServoAccelerationTolerance;
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"from_milli\":%ld,\"to_milli\":%ld,"
+                "\"settle_steps\":%lu,\"overshoot_ppm\":%lu,\"max_acceleration_milli\":%lu,\"ok\":%s}\n",
+                name, cyphal_bench_platform(), (long)(k.from * 1000.0f), (long)(k.to * 1000.0f),
+                (unsigned long)r.settle_steps, (unsigned long)(r.overshoot * 1e6f),
+                (unsigned long)(r.max_acceleration * 1000.0f), ok ? "true" : "false");
+}
+
+/* ---- Profile ---- */
+
+#if USAGI_PROFILE
+void print_prof(const char* name, ProfRegion region)
+{
+    ProfStats p;
+    prof_get(region, &p);
+    const uint32_t mean = (p.count > 0) ? (uint32_t)(p.total_cycles / p.count) : 0U;
+    std::printf("{\"bench\":\"%s\",\"platform\":\"%s\",\"fdcan_fast_path\":%s,\"count\":%lu,"
+                "\"min_cycles\":%lu,\"mean_cycles\":%lu,\"max_cycles\":%lu}\n",
+                name, cyphal_bench_platform(), CYPHAL_FDCAN_FAST_PATH ? "true" : "false",
+                (unsigned long)p.count, (unsigned long)p.min_cycles, (unsigned long)mean,
+                (unsigned long)p.max_cycles);
+}
+#endif
+
+} // namespace
+
+extern "C" void cyphal_bench_set_recording(const CyphalBenchFrame* frames, size_t count)
+{
+    s_recording       = frames;
+    s_recording_count = count;
+}
+
+extern "C" void CyphalBenchTask(void* pvParameters)
+{
+    (void)pvParameters;
+    auto& transport = CyphalTransport::instance();
+    transport.set_task_handle(xTaskGetCurrentTaskHandle());
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* kRxSubjectSingle は 8 バイトの単一フレームしか流さないので単一フレーム経路で受ける */
+    if (!transport.subscribe(kRxSubjectSingle, kRxExtent, on_rx, nullptr, true) ||
+        !transport.subscribe(kRxSubjectMulti, kRxExtent, on_rx) ||
+        !make_stream(kRxSubjectSingle, 8, s_single) ||
+        !make_stream(kRxSubjectMulti, kMultiPayload, s_multi)) {
+        std::printf("{\"bench\":\"error\",\"platform\":\"%s\"}\n", cyphal_bench_platform());
+        cyphal_bench_finish();
+    }
+
+    /* RX: FDCAN を起動する前なので、リングの producer は inject_rx だけ */
+    print_result("rx_single", run_rx(s_single, 1));
+    print_result("rx_single_burst16", run_rx(s_single, kBurst));
+    print_result("rx_multi", run_rx(s_multi, 1));
+    print_duplicate_result("rx_duplicate", run_rx_duplicate(s_single));
+    if (s_recording_count > 0) {
+        print_result("rx_replay", run_rx_replay());
+    }
+
+    run_crc("crc_sw", transfer_crc_add_sw);
+#if TRANSFER_CRC_HW
+    run_crc("crc_hw", transfer_crc_add);
+#endif
+
+    print_framing_result("tx_framing", run_tx_framing());
+    print_arena_result("tx_arena", run_tx_arena());
+    for (const ServoCase& k : kServoCases) {
+        print_servo_result("servo_limiter", k, run_servo_limiter(k));
+    }
+
+    /* TX */
+    cyphal_bench_prepare_bus();
+    transport.start_fdcan();
+
+    Result rx_bus;
+    if (run_rx_bus(s_single, rx_bus)) {
+        print_result("rx_fdcan", rx_bus);
+    }
+    FilterResult filter;
+    if (run_rx_filter(s_single, filter)) {
+        print_filter_result("rx_filter", filter);
+    }
+
+    uavcan::node::Heartbeat_1_0 hb{};
+    hb.health.value = uavcan::node::Health_1_0::NOMINAL;
+    hb.mode.value   = uavcan::node::Mode_1_0::OPERATIONAL;
+    print_result("tx_heartbeat", run_tx(uavcan::node::Heartbeat_1_0::_traits_::FixedPortId, hb));
+
+    uavcan::primitive::array::Natural32_1_0 nat{};
+    for (uint32_t i = 0; i < 40; ++i) nat.value.push_back(i);  /* 161 B: CAN FD で 3 フレーム */
+    print_result("tx_multi", run_tx(kTxSubjectMulti, nat));
+
+    PriorityResult prio;
+    if (run_tx_priority(nat, uavcan::node::Heartbeat_1_0::_traits_::FixedPortId, hb, prio)) {
+        print_priority_result("tx_priority", prio);
+    }
+
+    DeadlineResult deadline;
+    if (run_tx_deadline(kTxSubjectDeadline, hb, hb, deadline)) {
+        print_deadline_result("tx_deadline", deadline);
+    }
+    if (run_tx_deadline(kTxSubjectDeadline, hb, nat, deadline)) {
+        print_deadline_result("tx_deadline_multi", deadline);
+    }
+
+#if USAGI_PROFILE
+    print_prof("prof_rx_read", PROF_RX_READ);
+    print_prof("prof_tx_write", PROF_TX_WRITE);
+#endif
+
+    cyphal_bench_finish();
+}
@@ -0,0 +1,93 @@
+/**
+ * @file cyphal_bench_port.c
+ * @brief Target side of cyphal_bench.h: DWT at SystemCoreClock, FDCAN internal loopback, COM1 output.
+ */
+
+#include "cyphal_bench.h"
+#include "fdcan.h"
+#include "main.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FDCAN_TX_BUFFERS  3U
+
+const char* cyphal_bench_platform(void)
+{
+    return "stm32g431";
+}
+
+uint32_t cyphal_bench_cycles_per_sec(void)
+{
+    return SystemCoreClock;
+}
+
+void cyphal_bench_prepare_bus(void)
+{
+    /* Internal loopback: frames complete without an ACK and never reach the external bus. */
+    if (HAL_FDCAN_DeInit(&hfdcan1) != HAL_OK) {
+        Error_Handler();
+    }
+    hfdcan1.Init.Mode = FDCAN_MODE_INTERNAL_LOOPBACK;
+    if (HAL_FDCAN_Init(&hfdcan1) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+bool cyphal_bench_service_tx(void)
+{
+    /* Not the FIFO free level: TXFQS.TFFL reads as 0 in queue mode. */
+    for (uint32_t b = 0; b < FDCAN_TX_BUFFERS; b++) {
+        if (HAL_FDCAN_IsTxBufferMessagePending(&hfdcan1, 1UL << b) != 0U) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool cyphal_bench_bus_transmit(CyphalBenchFrame* out)
+{
+    (void)out;
+    return false;
+}
+
+bool cyphal_bench_bus_receive(const CyphalBenchFrame* frame)
+{
+    /* Internal loopback: the frame comes back through the filters and RX FIFO0 when it completes. */
+    static const uint8_t kDlcToLen[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+    uint32_t dlc = 0;
+    while (dlc < 15U && kDlcToLen[dlc] < frame->size) {
+        dlc++;
+    }
+    const FDCAN_TxHeaderTypeDef header = {
+        .Identifier          = frame->can_id,
+        .IdType              = FDCAN_EXTENDED_ID,
+        .TxFrameType         = FDCAN_DATA_FRAME,
+        .DataLength          = dlc,
+        .ErrorStateIndicator = FDCAN_ESI_ACTIVE,
+        .BitRateSwitch       = FDCAN_BRS_ON,
+        .FDFormat            = FDCAN_FD_CAN,
+        .TxEventFifoControl  = FDCAN_NO_TX_EVENTS,
+        .MessageMarker       = 0,
+    };
+    uint8_t data[64] = { 0 };
+    memcpy(data, frame->data, frame->size);
+    while (!cyphal_bench_service_tx()) {
+    }
+    if (HAL_FDCAN_AddMessageToTxFifoQ(&hfdcan1, &header, data) != HAL_OK) {
+        return false;
+    }
+    const uint32_t buffer = HAL_FDCAN_GetLatestTxFifoQRequestBuffer(&hfdcan1);
+    while (HAL_FDCAN_IsTxBufferMessagePending(&hfdcan1, buffer) != 0U) {
+    }
+    return true;
+}
+
+void cyphal_bench_finish(void)
+{
+    printf("{\"bench\":\"done\",\"platform\":\"%s\"}\n", cyphal_bench_platform());
+    vTaskDelete(NULL);
+    for (;;) {
+    }
+}
@@ -1,21 +1,179 @@
 /**
  * @file cyphal_node.cpp
- * @brief FreeRTOS タスクのみ。transport の step と actuator の apply を回す。
+ * @brief FreeRTOS タスクのみ。transport の step と定期送信を回す（actuator の apply は ActuatorTask）。
  */
 
 #include "cyphal_transport.hpp"
 #include "cyphal_publish.hpp"
-#include "actuator_command.h"
+#include "actuator_loop.h"
 #include "cyphal_node.h"
+#include "cycle_profiler.h"
 #include "FreeRTOS.h"
 #include "portmacro.h"
 #include "projdefs.h"
 #include "task.h"
 #include <uavcan/node/Heartbeat_1_0.hpp>
+#include <uavcan/primitive/array/Natural32_1_0.hpp>
+
+using Natural32 = uavcan::primitive::array::Natural32_1_0;
+
+/* uavcan.primitive.array.Natural32.1.0 の value は uint32[<=64] */
+static constexpr std::size_t kNatural32Capacity = 64;
+
+/*
+ * 以下の統計メッセージ（s_*_msg）はファイルスコープに置き、value を cyphal_node_init() で
+ * kNatural32Capacity まで reserve しておく。送信のたびに clear() して詰め直すので、周期ごとのヒープ確保はない。
+ */
+
+/* 統計の定期送信が失敗した回数（TX キュー満杯・シリアライズ失敗） */
+static std::uint32_t s_stats_publish_failures = 0;
+
+/** 統計の定期送信。失敗は数えるだけで再送しない（値は累積なので次の周期で追いつく）。 */
+template<typename T>
+static void publish_stats(CanardPortID subject_id, CanardTransferID& tid, const T& msg)
+{
+    if (!cyphal::publish(subject_id, tid, msg)) s_stats_publish_failures++;
+}
+
+#if USAGI_PROFILE
+/* 区間計測の送信先。値は [区間数, (count, min, max, mean) × 区間] の順（区間は ProfRegion 順）。 */
+static constexpr CanardPortID kSubjectProfile  = 3900;
+static constexpr TickType_t   kProfilePeriodMs = 5000;
+
+static_assert(1 + 4 * PROF_REGION_COUNT <= kNatural32Capacity,
+              "profile does not fit in one Natural32 message");
+
+static Natural32 s_profile_msg{};
+
+static void publish_profile(CanardTransferID& tid)
+{
+    auto& value = s_profile_msg.value;
+    value.clear();
+    value.push_back(PROF_REGION_COUNT);
+    for (int r = 0; r < PROF_REGION_COUNT; ++r) {
+        ProfStats s;
+        prof_get(static_cast<ProfRegion>(r), &s);
+        value.push_back(s.count);
+        value.push_back(s.min_cycles);
+        value.push_back(s.max_cycles);
+        value.push_back((s.count > 0) ? static_cast<std::uint32_t>(s.total_cycles / s.count) : 0U);
+    }
+    publish_stats(kSubjectProfile, tid, s_profile_msg);
+}
+#endif
+
+/* アクチュエータ更新の周期統計。値は [periods, overruns, timeouts, max_latency_usec, max_jitter_usec]。 */
+static constexpr CanardPortID kSubjectActuatorTiming = 3901;
+
+static Natural32 s_actuator_timing_msg{};
+
+static void publish_actuator_timing(CanardTransferID& tid)
+{
+    ActuatorLoopStats s;
+    actuator_loop_get_stats(&s);
+    auto& value = s_actuator_timing_msg.value;
+    value.clear();
+    value.push_back(s.periods);
+    value.push_back(s.overruns);
+    value.push_back(s.timeouts);
+    value.push_back(s.max_latency_usec);
+    value.push_back(s.max_jitter_usec);
+    publish_stats(kSubjectActuatorTiming, tid, s_actuator_timing_msg);
+}
+
+/*
+ * RTOS 統計。スタックとヒープのサイズ決め用。値は
+ *   [タスク数, heap_4 の現在の空き, 起動後の最小空き, 統計送信の失敗回数,
+ *    (タスク名の先頭 4 文字, CPU 使用率 [‰], スタック残りの最小値 [B]) × タスク]
+ * の順。タスク名は 4 文字を little-endian で詰め、4 文字未満は 0 で埋める。
+ * CPU 使用率は前回送信からの区間で、スタック残りは high-water mark。
+ */
+static constexpr CanardPortID kSubjectRtosStats  = 3902;
+static constexpr TickType_t   kRtosStatsPeriodMs = 5000;
+static constexpr UBaseType_t  kRtosStatsMaxTasks = 8;
+static constexpr std::size_t  kRtosStatsHeader   = 4;
+static constexpr std::size_t  kRtosStatsPerTask  = 3;
+
+static_assert(kRtosStatsHeader + kRtosStatsPerTask * kRtosStatsMaxTasks <= kNatural32Capacity,
+              "RTOS stats do not fit in one Natural32 message");
+
+static Natural32 s_rtos_stats_msg{};
+
+static std::uint32_t pack_task_name(const char* name)
+{
+    std::uint32_t packed = 0;
+    for (unsigned i = 0; i < 4U && name[i] != '\0'; ++i) {
+        packed |= static_cast<std::uint32_t>(static_cast<unsigned char>(name[i])) << (8U * i);
+    }
+    return packed;
+}
+
+static void publish_rtos_stats(CanardTransferID& tid)
+{
+    /* 前回値は xTaskNumber で引く（タスクの生成・削除があっても取り違えない） */
+    struct Previous {
+        UBaseType_t                 number;
+        configRUN_TIME_COUNTER_TYPE run_time;
+    };
+    static TaskStatus_t                tasks[kRtosStatsMaxTasks];
+    static Previous                    previous[kRtosStatsMaxTasks];
+    static UBaseType_t                 previous_count = 0;
+    static configRUN_TIME_COUNTER_TYPE previous_total = 0;
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    const UBaseType_t count = uxTaskGetSystemState(tasks, kRtosStatsMaxTasks, &total);
+    const configRUN_TIME_COUNTER_TYPE elapsed = total - previous_total;
+
+    auto& value = s_rtos_stats_msg.value;
+    value.clear();
+    value.push_back(static_cast<std::uint32_t>(count));
+    value.push_back(static_cast<std::uint32_t>(xPortGetFreeHeapSize()));
+    value.push_back(static_cast<std::uint32_t>(xPortGetMinimumEverFreeHeapSize()));
+    value.push_back(s_stats_publish_failures);
+    for (UBaseType_t i = 0; i < count; ++i) {
+        const TaskStatus_t& t = tasks[i];
+        configRUN_TIME_COUNTER_TYPE run_time = t.ulRunTimeCounter;
+        for (UBaseType_t j = 0; j < previous_count; ++j) {
+            if (previous[j].number == t.xTaskNumber) {
+                run_time -= previous[j].run_time;
+                break;
+            }
+        }
+        const std::uint32_t permille =
+            (elapsed > 0) ? static_cast<std::uint32_t>((run_time * 1000U) / elapsed) : 0U;
+
+        value.push_back(pack_task_name(t.pcTaskName));
+        value.push_back(permille);
+        value.push_back(static_cast<std::uint32_t>(t.usStackHighWaterMark * sizeof(StackType_t)));
+    }
+
+    for (UBaseType_t i = 0; i < count; ++i) {
+        previous[i] = {tasks[i].xTaskNumber, tasks[i].ulRunTimeCounter};
+    }
+    previous_count = count;
+    previous_total = total;
+
+    publish_stats(kSubjectRtosStats, tid, s_rtos_stats_msg);
+}
 
 extern "C" bool cyphal_node_init(void)
 {
-    return CyphalTransport::instance().init();
+    auto& transport = CyphalTransport::instance();
+    if (!transport.init()) return false;
+
+    /* Heartbeat は 1 s 周期なので、次の送信までに出られなければ捨てる */
+    transport.set_tx_options(uavcan::node::Heartbeat_1_0::_traits_::FixedPortId,
+                             {CanardPriorityNominal, 1000U * 1000U});
+    /* 統計は制御系の通信に譲る */
+    transport.set_tx_options(kSubjectRtosStats, {CanardPriorityOptional, 1000U * 1000U});
+    s_rtos_stats_msg.value.reserve(kNatural32Capacity);
+    transport.set_tx_options(kSubjectActuatorTiming, {CanardPriorityOptional, 1000U * 1000U});
+    s_actuator_timing_msg.value.reserve(kNatural32Capacity);
+#if USAGI_PROFILE
+    transport.set_tx_options(kSubjectProfile, {CanardPriorityOptional, 1000U * 1000U});
+    s_profile_msg.value.reserve(kNatural32Capacity);
+#endif
+    return true;
 }
 
 extern "C" void CyphalControlTask(void* pvParameters)
@@ -27,11 +185,17 @@ extern "C" void CyphalControlTask(void* pvParameters)
 
     TickType_t last_heartbeat = xTaskGetTickCount();
     static CanardTransferID tid_heartbeat{0};
+    TickType_t last_rtos_stats = last_heartbeat;
+    static CanardTransferID tid_rtos_stats{0};
+    static CanardTransferID tid_actuator_timing{0};
+#if USAGI_PROFILE
+    TickType_t last_profile = last_heartbeat;
+    static CanardTransferID tid_profile{0};
+#endif
 
     for (;;) {
-        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(20));
+        transport.wait(pdMS_TO_TICKS(20));
         transport.step();
-        actuator_command_apply();
 
         TickType_t now = xTaskGetTickCount();
         if ((now - last_heartbeat) >= pdMS_TO_TICKS(1000)) {
@@ -44,5 +208,16 @@ extern "C" void CyphalControlTask(void* pvParameters)
 
             cyphal::publish(uavcan::node::Heartbeat_1_0::_traits_::FixedPortId, tid_heartbeat, hb);
         }
+        if ((now - last_rtos_stats) >= pdMS_TO_TICKS(kRtosStatsPeriodMs)) {
+            last_rtos_stats = now;
+            publish_rtos_stats(tid_rtos_stats);
+            publish_actuator_timing(tid_actuator_timing);
+        }
+#if USAGI_PROFILE
+        if ((now - last_profile) >= pdMS_TO_TICKS(kProfilePeriodMs)) {
+            last_profile = now;
+            publish_profile(tid_profile);
+        }
+#endif
     }
 }
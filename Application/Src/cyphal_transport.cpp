@@ -1,15 +1,20 @@
 /**
  * @file cyphal_transport.cpp
- * @brief CyphalTransport 実装: canard / FDCAN ブリッジ / RX・TX キュー管理。
+ * @brief CyphalTransport 実装: canard（RX）/ FDCAN ブリッジ / RX・TX キュー管理。
  */
 
 #include "cyphal_transport.hpp"
 #include "app_memory.h"
-#include "FreeRTOSConfig.h"
+#include "cycle_profiler.h"
+#if CYPHAL_FDCAN_FAST_PATH
+#include "fdcan_fast.h"
+#endif
+#include "mono_clock.h"
+#include "transfer_crc.h"
 #include <cstring>
 
-#define TICK_TO_USEC(tick) \
-    ((CanardMicrosecond)(tick) * 1000000UL / (CanardMicrosecond)configTICK_RATE_HZ)
+static_assert(PROF_RX_HANDLER_LAST - PROF_RX_HANDLER_0 + 1 == CyphalTransport::kMaxSubscriptions,
+              "one profiler region per subscription slot");
 
 /* ----------------------------------------------------------------------- */
 /* Singleton                                                                */
@@ -32,26 +37,65 @@ extern "C" void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef* hfdcan, uint32_t
     CyphalTransport::instance().isr_rx(hfdcan);
 }
 
+extern "C" void HAL_FDCAN_TxBufferCompleteCallback(FDCAN_HandleTypeDef* hfdcan, uint32_t BufferIndexes)
+{
+    (void)BufferIndexes;
+    CyphalTransport::instance().isr_tx_complete(hfdcan);
+}
+
 void CyphalTransport::isr_rx(FDCAN_HandleTypeDef* hfdcan)
 {
-    if (hfdcan != &hfdcan1 || rx_queue_ == nullptr) return;
+    if (hfdcan != &hfdcan1) return;
+    PROF_BEGIN(prof_start);
+    rx_stats_.isr_entries++;
 
-    FDCAN_RxHeaderTypeDef header;
-    RxFrame frame;
-    while (HAL_FDCAN_GetRxMessage(hfdcan, FDCAN_RX_FIFO0, &header, frame.data) == HAL_OK) {
-        frame.can_id = header.Identifier;
-        frame.size   = dlc_to_len(header.DataLength);
-        if (frame.size > CANARD_MTU_CAN_FD) frame.size = CANARD_MTU_CAN_FD;
-
-        BaseType_t woken = pdFALSE;
-        if (xQueueSendFromISR(rx_queue_, &frame, &woken) != pdTRUE) {
-            frames_dropped_++;
+    /* FIFO を空になるまで読み切り、通知と yield は最後に 1 回だけ行う */
+    uint32_t published = 0;
+    for (;;) {
+        /* リングのスロットへ直接読み出す。満杯なら FIFO を空けるために捨て場へ読む。 */
+        RxFrame* slot  = rx_ring_.acquire();
+        RxFrame* frame = (slot != nullptr) ? slot : &rx_discard_;
+        PROF_BEGIN(read_start);
+        if (!read_rx_element(hfdcan, *frame)) {
+            break;
         }
-        if (task_handle_ != nullptr) {
-            vTaskNotifyGiveFromISR(task_handle_, &woken);
+        PROF_END(PROF_RX_READ, read_start);
+        rx_stats_.frames++;
+        if (slot == nullptr) {
+            frames_dropped_++;
+            continue;
         }
-        portYIELD_FROM_ISR(woken);
+        /* 到着時刻はここで取る。process_rx で取るとタスクの遅延分だけ後ろにずれる。 */
+        frame->timestamp_usec = mono_clock_usec();
+        rx_ring_.commit();
+        published++;
+    }
+
+    BaseType_t woken = pdFALSE;
+    if (published > 0 && task_handle_ != nullptr &&
+        rx_ring_.size() >= rx_wake_policy_.watermark) {
+        vTaskNotifyGiveFromISR(task_handle_, &woken);
+        rx_stats_.notifications++;
     }
+
+    PROF_END(PROF_ISR_RX, prof_start);
+    portYIELD_FROM_ISR(woken);
+}
+
+void CyphalTransport::isr_tx_complete(FDCAN_HandleTypeDef* hfdcan)
+{
+    if (hfdcan != &hfdcan1) return;
+
+    /* ワンショット: 再充填はタスク側で行い、必要なら flush_tx が再度有効化する。
+     * TX キューはタスク専有のまま（ISR からは触らない）。 */
+    __HAL_FDCAN_DISABLE_IT(hfdcan, FDCAN_IT_TX_COMPLETE);
+
+    BaseType_t woken = pdFALSE;
+    if (task_handle_ != nullptr) {
+        vTaskNotifyGiveFromISR(task_handle_, &woken);
+        tx_stats_.refill_irqs++;
+    }
+    portYIELD_FROM_ISR(woken);
 }
 
 /* ----------------------------------------------------------------------- */
@@ -61,15 +105,19 @@ void CyphalTransport::isr_rx(FDCAN_HandleTypeDef* hfdcan)
 bool CyphalTransport::init(CanardNodeID node_id)
 {
     struct CanardMemoryResource mem = app_memory_canard_resource();
-    canard_   = canardInit(mem);
-    tx_queue_ = canardTxInit(kTxQueueCapacity, CANARD_MTU_CAN_FD, mem);
+    canard_ = canardInit(mem);
     canard_.node_id = node_id;
+    tx_queue_.init();
+    tx_reserved_ = nullptr;
 
-    rx_queue_ = xQueueCreate(kRxQueueLen, sizeof(RxFrame));
-    if (rx_queue_ == nullptr) return false;
-
+    prof_init();
+    transfer_crc_init();
     frames_dropped_ = 0;
-    sub_count_      = 0;
+    rx_stats_       = RxStats{};
+    tx_stats_       = TxStats{};
+    tx_hw_can_id_.fill(0);
+    sub_count_        = 0;
+    tx_subject_count_ = 0;
     return true;
 }
 
@@ -80,68 +128,201 @@ void CyphalTransport::set_task_handle(TaskHandle_t handle)
 
 void CyphalTransport::start_fdcan()
 {
+    rx_hw_filtered_ = configure_rx_filters();
+
     if (HAL_FDCAN_ActivateNotification(&hfdcan1, FDCAN_IT_RX_FIFO0_NEW_MESSAGE, 0) != HAL_OK) {
         return;
     }
+#if CYPHAL_TX_IRQ_REFILL
+    /* TXBTIE（全 TX バッファ）と割り込みラインを設定し、TCE 自体は arm_tx_complete() まで止めておく */
+    if (HAL_FDCAN_ActivateNotification(&hfdcan1, FDCAN_IT_TX_COMPLETE,
+            FDCAN_TX_BUFFER0 | FDCAN_TX_BUFFER1 | FDCAN_TX_BUFFER2) != HAL_OK) {
+        return;
+    }
+    __HAL_FDCAN_DISABLE_IT(&hfdcan1, FDCAN_IT_TX_COMPLETE);
+#endif
     HAL_FDCAN_Start(&hfdcan1);
 }
 
+void CyphalTransport::set_rx_wake_policy(const RxWakePolicy& policy)
+{
+    rx_wake_policy_ = policy;
+    if (rx_wake_policy_.watermark == 0) rx_wake_policy_.watermark = 1;
+    if (rx_wake_policy_.watermark > kRxQueueLen) rx_wake_policy_.watermark = kRxQueueLen;
+    if (rx_wake_policy_.idle_timeout_ticks == 0) rx_wake_policy_.idle_timeout_ticks = 1;
+}
+
+void CyphalTransport::wait(TickType_t max_wait)
+{
+    TickType_t timeout = max_wait;
+    if (rx_wake_policy_.watermark > 1 && rx_wake_policy_.idle_timeout_ticks < timeout) {
+        timeout = rx_wake_policy_.idle_timeout_ticks;
+    }
+    if (ulTaskNotifyTake(pdTRUE, timeout) != 0) {
+        rx_stats_.task_wakeups++;
+    } else {
+        rx_stats_.task_timeouts++;
+    }
+}
+
 void CyphalTransport::step()
 {
     process_rx();
     flush_tx();
 }
 
+bool CyphalTransport::rx_hw_filtered() const
+{
+    return rx_hw_filtered_;
+}
+
 uint32_t CyphalTransport::frames_dropped() const
 {
     return frames_dropped_;
 }
 
+CyphalTransport::RxStats CyphalTransport::rx_stats() const
+{
+    return rx_stats_;
+}
+
+CyphalTransport::TxStats CyphalTransport::tx_stats() const
+{
+    return tx_stats_;
+}
+
+size_t CyphalTransport::tx_pending() const
+{
+    return tx_queue_.frames_pending();
+}
+
+bool CyphalTransport::inject_rx(uint32_t can_id, const uint8_t* data, uint8_t size,
+                                CanardMicrosecond timestamp_usec)
+{
+    RxFrame* slot = rx_ring_.acquire();
+    if (slot == nullptr) return false;
+    if (size > CANARD_MTU_CAN_FD) size = CANARD_MTU_CAN_FD;
+    slot->timestamp_usec = timestamp_usec;
+    slot->can_id         = can_id;
+    slot->size           = size;
+    std::memcpy(slot->data, data, size);
+    rx_ring_.commit();
+    return true;
+}
+
 /* ----------------------------------------------------------------------- */
 /* Subscribe                                                                */
 /* ----------------------------------------------------------------------- */
 
 bool CyphalTransport::subscribe(CanardPortID subject_id, size_t extent,
-                                std::function<void(const CanardRxTransfer&)> callback)
+                                RxHandler handler, void* context, bool single_frame)
 {
-    if (sub_count_ >= kMaxSubscriptions) return false;
+    if (sub_count_ >= kMaxSubscriptions || handler == nullptr) return false;
+#if APP_MEMORY_BACKEND == APP_MEMORY_BACKEND_POOL
+    /* マルチフレーム転送は extent 分を丸ごと確保するので、プールのブロックに収まらなければ受けられない */
+    if (extent > APP_MEMORY_REASSEMBLY_SIZE) return false;
+#endif
 
     Sub& s = subs_[sub_count_];
-    s.callback = std::move(callback);
+    s.handler = handler;
+    s.context = context;
+    s.single_frame = single_frame;
+    for (RxSession& r : s.sessions) r.node_id = CANARD_NODE_ID_UNSET;
 
     const int8_t result = canardRxSubscribe(
         &canard_, CanardTransferKindMessage, subject_id, extent,
         CANARD_DEFAULT_TRANSFER_ID_TIMEOUT_USEC, &s.entry);
     if (result < 0) return false;
+    s.entry.user_reference = &s;
 
     ++sub_count_;
     return true;
 }
 
 /* ----------------------------------------------------------------------- */
-/* RX: drain queue → canardRxAccept → callback                             */
+/* RX filter: subscription table → FDCAN extended filter elements          */
+/* ----------------------------------------------------------------------- */
+
+bool CyphalTransport::configure_rx_filters()
+{
+    const bool     has_node_id = (canard_.node_id <= CANARD_NODE_ID_MAX);
+    const uint32_t required    = sub_count_ + (has_node_id ? 1U : 0U);
+    const uint32_t available   = hfdcan1.Init.ExtFiltersNbr;
+
+    /* 全部載らないなら MX_FDCAN1_Init の全受理設定のまま canard 側で選別する */
+    if (required == 0 || required > available) return false;
+
+    FDCAN_FilterTypeDef f = {
+        .IdType       = FDCAN_EXTENDED_ID,
+        .FilterIndex  = 0,
+        .FilterType   = FDCAN_FILTER_MASK,
+        .FilterConfig = FDCAN_FILTER_TO_RXFIFO0,
+        .FilterID1    = 0,
+        .FilterID2    = 0,
+    };
+    for (size_t i = 0; i < sub_count_; ++i) {
+        const CanardFilter cf = canardMakeFilterForSubject(subs_[i].entry.port_id);
+        f.FilterID1 = cf.extended_can_id;
+        f.FilterID2 = cf.extended_mask;
+        if (HAL_FDCAN_ConfigFilter(&hfdcan1, &f) != HAL_OK) return false;
+        f.FilterIndex++;
+    }
+    if (has_node_id) {
+        /* 自ノード宛てのサービス要求・応答 */
+        const CanardFilter cf = canardMakeFilterForServices(canard_.node_id);
+        f.FilterID1 = cf.extended_can_id;
+        f.FilterID2 = cf.extended_mask;
+        if (HAL_FDCAN_ConfigFilter(&hfdcan1, &f) != HAL_OK) return false;
+        f.FilterIndex++;
+    }
+    /* 残りの要素は無効化しておく */
+    f.FilterConfig = FDCAN_FILTER_DISABLE;
+    f.FilterID1    = 0;
+    f.FilterID2    = 0;
+    for (; f.FilterIndex < available; f.FilterIndex++) {
+        if (HAL_FDCAN_ConfigFilter(&hfdcan1, &f) != HAL_OK) return false;
+    }
+
+    return HAL_FDCAN_ConfigGlobalFilter(&hfdcan1,
+                                        FDCAN_REJECT,         /* NonMatchingStd */
+                                        FDCAN_REJECT,         /* NonMatchingExt */
+                                        FDCAN_REJECT_REMOTE,  /* RejectRemoteStd */
+                                        FDCAN_REJECT_REMOTE) == HAL_OK;
+}
+
+/* ----------------------------------------------------------------------- */
+/* RX: drain ring → canardRxAccept → callback                              */
 /* ----------------------------------------------------------------------- */
 
 void CyphalTransport::process_rx()
 {
-    RxFrame frame;
-    while (xQueueReceive(rx_queue_, &frame, 0) == pdTRUE) {
-        CanardFrame can_frame = {
-            .extended_can_id = frame.can_id,
-            .payload = { .size = frame.size, .data = frame.data },
+    if (rx_ring_.front() == nullptr) return;  /* 空振りは計測に入れない */
+    PROF_SCOPE(PROF_PROCESS_RX);
+
+    while (const RxFrame* frame = rx_ring_.front()) {
+#if CYPHAL_RX_SINGLE_FRAME_BYPASS
+        /* スロットはハンドラが戻るまで ISR に返さない */
+        if (deliver_single_frame(*frame)) {
+            rx_ring_.release();
+            continue;
+        }
+#endif
+        const CanardFrame can_frame = {
+            .extended_can_id = frame->can_id,
+            .payload = { .size = frame->size, .data = frame->data },
         };
-        const CanardMicrosecond ts = TICK_TO_USEC(xTaskGetTickCount());
-        CanardRxTransfer        transfer;
-        CanardRxSubscription*   out_sub = nullptr;
+        CanardRxTransfer      transfer;
+        CanardRxSubscription* out_sub = nullptr;
         const int8_t result = canardRxAccept(
-            &canard_, ts, &can_frame, 0, &transfer, &out_sub);
+            &canard_, frame->timestamp_usec, &can_frame, 0, &transfer, &out_sub);
+        /* canard はペイロードを自前のバッファにコピー済みなので、ここでスロットを返す */
+        rx_ring_.release();
 
         if (result == 1 && out_sub != nullptr) {
-            for (size_t i = 0; i < sub_count_; ++i) {
-                if (&subs_[i].entry == out_sub) {
-                    subs_[i].callback(transfer);
-                    break;
-                }
+            rx_stats_.transfers++;
+            const Sub* s = static_cast<const Sub*>(out_sub->user_reference);
+            if (s != nullptr) {
+                dispatch(*s, transfer);
             }
             if (transfer.payload.data != nullptr && transfer.payload.allocated_size > 0) {
                 canard_.memory.deallocate(canard_.memory.user_reference,
@@ -152,64 +333,322 @@ void CyphalTransport::process_rx()
     }
 }
 
+bool CyphalTransport::deliver_single_frame(const RxFrame& frame)
+{
+    /* テールバイト: start / end of transfer がともに立ち、toggle = 1 なら単一フレーム転送 */
+    constexpr uint8_t kTailSingleFrame = 0x80U | 0x40U | 0x20U;
+    /* CAN ID: bit 25 = サービス、bit 23 と bit 7 = 予約（0 でなければ canard に判断させる） */
+    constexpr uint32_t kIdServiceOrReserved = (1UL << 25) | (1UL << 23) | (1UL << 7);
+    constexpr uint32_t kIdAnonymous         = 1UL << 24;
+
+    if (frame.size == 0) return false;
+    const uint8_t tail = frame.data[frame.size - 1U];
+    if ((tail & kTailSingleFrame) != kTailSingleFrame) return false;
+    const uint32_t can_id = frame.can_id;
+    if ((can_id & kIdServiceOrReserved) != 0U) return false;
+    /* マルチフレームもあり得る型は transfer-ID の列を canard のセッションに一本化する */
+    Sub* s = find_sub((CanardPortID)((can_id >> 8) & CANARD_SUBJECT_ID_MAX));
+    if (s == nullptr || !s->single_frame) return false;
+
+    /* canard と同じく、匿名の転送はセッションを持たないので重複検出しない */
+    const CanardNodeID     source      = ((can_id & kIdAnonymous) != 0U)
+                                             ? (CanardNodeID)CANARD_NODE_ID_UNSET
+                                             : (CanardNodeID)(can_id & CANARD_NODE_ID_MAX);
+    const CanardTransferID transfer_id = (CanardTransferID)(tail & CANARD_TRANSFER_ID_MAX);
+    if (source != CANARD_NODE_ID_UNSET && rx_duplicate(*s, source, transfer_id, frame.timestamp_usec)) {
+        rx_stats_.duplicates++;
+        return true;
+    }
+
+    /* canard の単一フレーム受理と同じ形にする（パディングは残し、extent で切り詰める） */
+    CanardRxTransfer transfer{};
+    transfer.metadata.priority       = (CanardPriority)((can_id >> 26) & 7U);
+    transfer.metadata.transfer_kind  = CanardTransferKindMessage;
+    transfer.metadata.port_id        = s->entry.port_id;
+    transfer.metadata.remote_node_id = source;
+    transfer.metadata.transfer_id    = transfer_id;
+    transfer.timestamp_usec          = frame.timestamp_usec;
+    const size_t size = frame.size - 1U;
+    transfer.payload.size            = (size < s->entry.extent) ? size : s->entry.extent;
+    transfer.payload.data            = const_cast<uint8_t*>(frame.data);
+    transfer.payload.allocated_size  = 0;
+
+    rx_stats_.transfers++;
+    rx_stats_.single_frame++;
+    dispatch(*s, transfer);
+    return true;
+}
+
+/*
+ * canard の rxSessionUpdate と同じ判定: 同じ送信元の前回と transfer-ID が同じで、
+ * 前回から transfer_id_timeout_usec 以内なら重複。捨てた転送では時刻を更新しない。
+ */
+bool CyphalTransport::rx_duplicate(Sub& s, CanardNodeID source, CanardTransferID transfer_id,
+                                   CanardMicrosecond timestamp_usec)
+{
+    RxSession* session = nullptr;
+    RxSession* victim  = &s.sessions[0];  /* 空きか、最も古い送信元 */
+    for (RxSession& r : s.sessions) {
+        if (r.node_id == source) {
+            session = &r;
+            break;
+        }
+        if (victim->node_id != CANARD_NODE_ID_UNSET &&
+            (r.node_id == CANARD_NODE_ID_UNSET || r.timestamp_usec < victim->timestamp_usec)) {
+            victim = &r;
+        }
+    }
+
+    if (session != nullptr) {
+        const bool timed_out = (timestamp_usec > session->timestamp_usec) &&
+                               (timestamp_usec - session->timestamp_usec > s.entry.transfer_id_timeout_usec);
+        if (!timed_out && transfer_id == session->transfer_id) return true;
+    } else {
+        session          = victim;
+        session->node_id = source;
+    }
+    session->transfer_id    = transfer_id;
+    session->timestamp_usec = timestamp_usec;
+    return false;
+}
+
+CyphalTransport::Sub* CyphalTransport::find_sub(CanardPortID subject_id)
+{
+    for (size_t i = 0; i < sub_count_; ++i) {
+        if (subs_[i].entry.port_id == subject_id) return &subs_[i];
+    }
+    return nullptr;
+}
+
+void CyphalTransport::dispatch(const Sub& s, const CanardRxTransfer& transfer)
+{
+    PROF_BEGIN(prof_start);
+    s.handler(transfer, s.context);
+    PROF_END((ProfRegion)(PROF_RX_HANDLER_0 + (&s - subs_.data())), prof_start);
+}
+
 /* ----------------------------------------------------------------------- */
-/* TX: flush canard TX queue → FDCAN FIFO                                  */
+/* TX: flush TX transfer queue → FDCAN FIFO                               */
 /* ----------------------------------------------------------------------- */
 
 void CyphalTransport::flush_tx()
 {
-    const CanardMicrosecond now_usec = TICK_TO_USEC(xTaskGetTickCount());
-    for (;;) {
-        const CanardTxQueueItem* item = canardTxPeek(&tx_queue_);
-        if (item == nullptr) break;
-
-        if (item->tx_deadline_usec < now_usec) {
-            canardTxFree(&tx_queue_, &canard_,
-                         canardTxPop(&tx_queue_, const_cast<CanardTxQueueItem*>(item)));
+    if (tx_queue_.front() == nullptr) return;  /* 空振りは計測に入れない */
+    PROF_SCOPE(PROF_FLUSH_TX);
+
+    const CanardMicrosecond now_usec = mono_clock_usec();
+    while (TxTransferQueue::Transfer* t = tx_queue_.front()) {
+        if (t->deadline_usec < now_usec) {
+            tx_stats_.expired[(t->can_id >> 26) & 7U]++;
+            tx_stats_.expired_frames += tx_queue_.drop(*t);
             continue;
         }
 
-        FDCAN_TxHeaderTypeDef hdr = {
-            .Identifier          = item->frame.extended_can_id,
-            .IdType              = FDCAN_EXTENDED_ID,
-            .TxFrameType         = FDCAN_DATA_FRAME,
-            .DataLength          = (uint32_t)CanardCANLengthToDLC[item->frame.payload.size],
-            .ErrorStateIndicator = FDCAN_ESI_ACTIVE,
-            .BitRateSwitch       = FDCAN_BRS_ON,
-            .FDFormat            = FDCAN_FD_CAN,
-            .TxEventFifoControl  = FDCAN_NO_TX_EVENTS,
-            .MessageMarker       = 0,
-        };
-        if (HAL_FDCAN_AddMessageToTxFifoQ(&hfdcan1, &hdr,
-                static_cast<const uint8_t*>(item->frame.payload.data)) != HAL_OK) {
-            break;  /* TX FIFO 満杯; 次の step で再試行 */
+        /* キューモードの HW は CAN ID の小さいバッファから送るが、同じ ID 同士はバッファ番号順で
+         * 積んだ順ではない。マルチフレーム転送（と同じ subject の後続転送）が入れ替わらないよう、
+         * 同じ ID が送信待ちの間は先頭で止めて TX 完了を待つ。 */
+        const uint32_t can_id = t->can_id;
+        if (hfdcan1.Init.TxFifoQueueMode == FDCAN_TX_QUEUE_OPERATION && tx_id_pending(can_id)) {
+            tx_stats_.same_id_waits++;
+            arm_tx_complete();
+#if CYPHAL_TX_IRQ_REFILL
+            /* 有効化する前に完了していた場合も同様に、毎回ここで拾う（次は必ず積みに進む） */
+            if (!tx_id_pending(can_id)) {
+                continue;
+            }
+#endif
+            break;
+        }
+
+        /* ペイロードはアリーナから HW の要素へ直接コピーする */
+        const TxTransferQueue::Frame frame = tx_queue_.next_frame(*t);
+        PROF_BEGIN(write_start);
+        if (!add_tx_element(frame)) {
+            /* TX FIFO 満杯; TX 完了割り込みで起こしてもらう */
+            tx_stats_.fifo_full++;
+            arm_tx_complete();
+#if CYPHAL_TX_IRQ_REFILL
+            /* 有効化する前に送信が完了していた場合は割り込みが来ないので、ここで拾う。
+             * 有効化のたびに確認する（空きがあれば次は積めるので、ループは必ず進む）。 */
+            if (tx_buffer_free()) {
+                continue;
+            }
+#endif
+            break;
+        }
+        PROF_END(PROF_TX_WRITE, write_start);
+        const uint32_t buffer = HAL_FDCAN_GetLatestTxFifoQRequestBuffer(&hfdcan1);
+        for (uint32_t b = 0; b < kTxBuffers; ++b) {
+            if ((buffer & (1UL << b)) != 0U) tx_hw_can_id_[b] = can_id;
+        }
+        record_tx_latency(*t, now_usec);
+        (void)tx_queue_.advance(*t);
+    }
+}
+
+void CyphalTransport::arm_tx_complete()
+{
+#if CYPHAL_TX_IRQ_REFILL
+    /* 以前の完了で立ったままの TC フラグで即座に割り込まないよう、先に落としてから有効化する */
+    __HAL_FDCAN_CLEAR_FLAG(&hfdcan1, FDCAN_FLAG_TX_COMPLETE);
+    __HAL_FDCAN_ENABLE_IT(&hfdcan1, FDCAN_IT_TX_COMPLETE);
+#endif
+}
+
+bool CyphalTransport::read_rx_element(FDCAN_HandleTypeDef* hfdcan, RxFrame& frame)
+{
+#if CYPHAL_FDCAN_FAST_PATH
+    return fdcan_fast_rx_fifo0_get(hfdcan, &frame.can_id, &frame.size, frame.data);
+#else
+    FDCAN_RxHeaderTypeDef header;
+    if (HAL_FDCAN_GetRxMessage(hfdcan, FDCAN_RX_FIFO0, &header, frame.data) != HAL_OK) {
+        return false;
+    }
+    frame.can_id = header.Identifier;
+    frame.size   = dlc_to_len(header.DataLength);
+    if (frame.size > CANARD_MTU_CAN_FD) frame.size = CANARD_MTU_CAN_FD;
+    return true;
+#endif
+}
+
+bool CyphalTransport::add_tx_element(const TxTransferQueue::Frame& frame)
+{
+    const uint32_t dlc = CanardCANLengthToDLC[frame.size];
+#if CYPHAL_FDCAN_FAST_PATH
+    return fdcan_fast_tx_add(&hfdcan1, frame.can_id, dlc, frame.payload, frame.payload_size,
+                             frame.trailer, frame.trailer_size);
+#else
+    /* HAL は連続したバッファを取るので、ここで 1 フレーム分に組み立てる */
+    uint8_t data[CANARD_MTU_CAN_FD] = {};
+    if (frame.payload_size > 0) std::memcpy(data, frame.payload, frame.payload_size);
+    std::memcpy(&data[frame.size - frame.trailer_size], frame.trailer, frame.trailer_size);
+    FDCAN_TxHeaderTypeDef hdr = {
+        .Identifier          = frame.can_id,
+        .IdType              = FDCAN_EXTENDED_ID,
+        .TxFrameType         = FDCAN_DATA_FRAME,
+        .DataLength          = dlc,
+        .ErrorStateIndicator = FDCAN_ESI_ACTIVE,
+        .BitRateSwitch       = FDCAN_BRS_ON,
+        .FDFormat            = FDCAN_FD_CAN,
+        .TxEventFifoControl  = FDCAN_NO_TX_EVENTS,
+        .MessageMarker       = 0,
+    };
+    return HAL_FDCAN_AddMessageToTxFifoQ(&hfdcan1, &hdr, data) == HAL_OK;
+#endif
+}
+
+bool CyphalTransport::tx_buffer_free() const
+{
+    /* HAL_FDCAN_GetTxFifoFreeLevel() は TXFQS.TFFL で、キューモードでは常に 0 になるので使えない */
+    for (uint32_t b = 0; b < kTxBuffers; ++b) {
+        if (HAL_FDCAN_IsTxBufferMessagePending(&hfdcan1, 1UL << b) == 0U) return true;
+    }
+    return false;
+}
+
+bool CyphalTransport::tx_id_pending(uint32_t can_id) const
+{
+    for (uint32_t b = 0; b < kTxBuffers; ++b) {
+        if (tx_hw_can_id_[b] == can_id &&
+            HAL_FDCAN_IsTxBufferMessagePending(&hfdcan1, 1UL << b) != 0U) {
+            return true;
         }
-        canardTxFree(&tx_queue_, &canard_,
-                     canardTxPop(&tx_queue_, const_cast<CanardTxQueueItem*>(item)));
     }
+    return false;
+}
+
+void CyphalTransport::record_tx_latency(const TxTransferQueue::Transfer& transfer,
+                                        CanardMicrosecond now_usec)
+{
+    const CanardMicrosecond elapsed_usec = now_usec - transfer.enqueued_usec;
+    const uint32_t latency = (elapsed_usec < UINT32_MAX) ? (uint32_t)elapsed_usec : UINT32_MAX;
+
+    size_t bin = 0;
+    while (bin < (kTxLatencyBins - 1) && latency >= kTxLatencyBinUsec[bin]) bin++;
+    tx_stats_.latency_hist[bin]++;
+    tx_stats_.frames++;
+    if (latency > tx_stats_.max_latency_usec) tx_stats_.max_latency_usec = latency;
 }
 
 /* ----------------------------------------------------------------------- */
-/* Push (型なし; cyphal_publish.cpp から使う)                              */
+/* Push (型なし; cyphal_publish.hpp から使う)                              */
 /* ----------------------------------------------------------------------- */
 
+bool CyphalTransport::set_tx_options(CanardPortID subject_id, const TxOptions& options)
+{
+    for (size_t i = 0; i < tx_subject_count_; ++i) {
+        if (tx_subjects_[i].subject_id == subject_id) {
+            tx_subjects_[i].options = options;
+            return true;
+        }
+    }
+    if (tx_subject_count_ >= kMaxTxSubjects) return false;
+    tx_subjects_[tx_subject_count_++] = TxSubject{subject_id, options};
+    return true;
+}
+
+CyphalTransport::TxOptions CyphalTransport::tx_options(CanardPortID subject_id) const
+{
+    for (size_t i = 0; i < tx_subject_count_; ++i) {
+        if (tx_subjects_[i].subject_id == subject_id) return tx_subjects_[i].options;
+    }
+    return kDefaultTxOptions;
+}
+
 bool CyphalTransport::push(CanardPortID subject_id, CanardTransferID& transfer_id,
                            const uint8_t* payload, size_t size)
 {
-    const CanardMicrosecond now_usec     = TICK_TO_USEC(xTaskGetTickCount());
-    const CanardMicrosecond deadline_usec = now_usec + (CanardMicrosecond)kTxDeadlineMs * 1000UL;
+    return push(subject_id, transfer_id, payload, size, tx_options(subject_id));
+}
 
-    const CanardTransferMetadata meta = {
-        .priority       = CanardPriorityNominal,
-        .transfer_kind  = CanardTransferKindMessage,
-        .port_id        = subject_id,
-        .remote_node_id = CANARD_NODE_ID_UNSET,
-        .transfer_id    = transfer_id++,
-    };
-    const CanardPayload canard_payload = { .size = size, .data = payload };
-    const int32_t result = canardTxPush(
-        &tx_queue_, &canard_, deadline_usec, &meta, canard_payload, now_usec, nullptr);
-    return (result >= 0);
+bool CyphalTransport::push(CanardPortID subject_id, CanardTransferID& transfer_id,
+                           const uint8_t* payload, size_t size, const TxOptions& options)
+{
+    uint8_t* const buf = tx_reserve(size);
+    if (buf == nullptr) return false;
+    if (size > 0) std::memcpy(buf, payload, size);
+    return tx_commit(subject_id, transfer_id, size, options);
+}
+
+uint8_t* CyphalTransport::tx_reserve(size_t max_size)
+{
+    tx_reserved_ = tx_queue_.reserve(max_size);
+    if (tx_reserved_ == nullptr) tx_stats_.queue_full++;
+    return tx_reserved_;
+}
+
+bool CyphalTransport::tx_commit(CanardPortID subject_id, CanardTransferID& transfer_id, size_t size,
+                                const TxOptions& options)
+{
+    const uint8_t* const payload = tx_reserved_;
+    tx_reserved_ = nullptr;
+    if (payload == nullptr) return false;
+    if (subject_id > CANARD_SUBJECT_ID_MAX || (uint32_t)options.priority >= kPriorityCount) {
+        tx_queue_.cancel();
+        return false;
+    }
+
+    /* メッセージの CAN ID: 優先度 | bit 22..21 = 1 | subject-ID | 送信元 */
+    uint32_t can_id = ((uint32_t)options.priority << 26) | (3UL << 21) | ((uint32_t)subject_id << 8);
+    if (canard_.node_id <= CANARD_NODE_ID_MAX) {
+        can_id |= canard_.node_id;
+    } else {
+        /* canard と同じく匿名は単一フレームだけで、送信元はペイロードの CRC から作る疑似 ID */
+        if (size > TxTransferQueue::kFramePayload) {
+            tx_queue_.cancel();
+            return false;
+        }
+        can_id |= (1UL << 24) | (transfer_crc_add(TRANSFER_CRC_INITIAL, payload, size) & CANARD_NODE_ID_MAX);
+    }
+
+    const CanardMicrosecond now_usec = mono_clock_usec();
+    return tx_queue_.commit(can_id, transfer_id++, size, now_usec, now_usec + options.deadline_usec);
+}
+
+void CyphalTransport::tx_cancel()
+{
+    tx_reserved_ = nullptr;
+    tx_queue_.cancel();
 }
 
 /* ----------------------------------------------------------------------- */
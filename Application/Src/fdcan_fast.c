@@ -0,0 +1,94 @@
+/**
+ * @file fdcan_fast.c
+ * @brief Word-level access to the FDCAN message RAM for RX FIFO0 and the TX FIFO/queue.
+ *
+ * The element layout is fixed on the G4 (SRAMCAN_RF0_SIZE / SRAMCAN_TFQ_SIZE: 2 header words
+ * followed by 16 data words); the base addresses come from hfdcan->msgRam set by HAL_FDCAN_Init.
+ * The message RAM only takes aligned word accesses; the caller's buffers may be unaligned, so
+ * they are moved with 4-byte memcpy (a single LDR/STR on the M4) and a byte tail.
+ * TX frames are gathered from a payload slice, implied zero padding and a short trailer
+ * (CRC / tail byte), so the caller never assembles the frame in a separate buffer.
+ * Registers go through READ_REG / WRITE_REG so that the host shim (Host/Src/hal_fdcan_host.c)
+ * sees the RXF0A / TXBAR writes; on the target they are plain volatile accesses.
+ */
+
+#include "fdcan_fast.h"
+#include <string.h>
+
+#define ELEMENT_BYTES    (18U * 4U)    /* SRAMCAN_RF0_SIZE == SRAMCAN_TFQ_SIZE */
+#define ELEMENT_ID_MASK  0x1FFFFFFFUL  /* W0: extended identifier */
+#define ELEMENT_DLC_POS  16U           /* W1: DLC[19:16] */
+
+static const uint8_t kDlcToLen[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+bool fdcan_fast_rx_fifo0_get(FDCAN_HandleTypeDef* hfdcan, uint32_t* can_id, uint8_t* size, uint8_t* data)
+{
+    FDCAN_GlobalTypeDef* const regs = hfdcan->Instance;
+    const uint32_t status = READ_REG(regs->RXF0S);
+    if ((status & FDCAN_RXF0S_F0FL) == 0U) {
+        return false;
+    }
+    const uint32_t get = (status & FDCAN_RXF0S_F0GI) >> FDCAN_RXF0S_F0GI_Pos;
+    const uint32_t* const element = (const uint32_t*)(hfdcan->msgRam.RxFIFO0SA + get * ELEMENT_BYTES);
+
+    const uint32_t len   = kDlcToLen[(element[1] >> ELEMENT_DLC_POS) & 0xFU];
+    const uint32_t words = len / 4U;
+    for (uint32_t i = 0; i < words; i++) {
+        const uint32_t w = element[2U + i];
+        memcpy(&data[4U * i], &w, sizeof(w));
+    }
+    if ((len & 3U) != 0U) {
+        const uint32_t w = element[2U + words];
+        memcpy(&data[4U * words], &w, len & 3U);
+    }
+    *can_id = element[0] & ELEMENT_ID_MASK;
+    *size   = (uint8_t)len;
+
+    WRITE_REG(regs->RXF0A, get);
+    return true;
+}
+
+bool fdcan_fast_tx_add(FDCAN_HandleTypeDef* hfdcan, uint32_t can_id, uint32_t dlc,
+                       const uint8_t* head, uint32_t head_len, const uint8_t* trailer, uint32_t trailer_len)
+{
+    FDCAN_GlobalTypeDef* const regs = hfdcan->Instance;
+    const uint32_t status = READ_REG(regs->TXFQS);
+    if ((status & FDCAN_TXFQS_TFQF) != 0U) {
+        return false;
+    }
+    const uint32_t put = (status & FDCAN_TXFQS_TFQPI) >> FDCAN_TXFQS_TFQPI_Pos;
+    uint32_t* const element = (uint32_t*)(hfdcan->msgRam.TxFIFOQSA + put * ELEMENT_BYTES);
+
+    /* ESI active, data frame, no TX event, message marker 0 */
+    element[0] = FDCAN_EXTENDED_ID | (can_id & ELEMENT_ID_MASK);
+    element[1] = FDCAN_FD_CAN | FDCAN_BRS_ON | ((dlc & 0xFU) << ELEMENT_DLC_POS);
+
+    /* Whole words of head go straight through; the word holding the head/zero/trailer
+     * boundaries is composed byte by byte. */
+    const uint32_t len        = kDlcToLen[dlc & 0xFU];
+    const uint32_t head_words = head_len / 4U;
+    const uint32_t trailer_at = len - trailer_len;
+    for (uint32_t i = 0; i < head_words; i++) {
+        uint32_t w;
+        memcpy(&w, &head[4U * i], sizeof(w));
+        element[2U + i] = w;
+    }
+    for (uint32_t i = head_words; i < (len + 3U) / 4U; i++) {
+        uint32_t w = 0;
+        for (uint32_t b = 0; b < 4U; b++) {
+            const uint32_t k = 4U * i + b;
+            uint32_t v = 0;
+            if (k < head_len) {
+                v = head[k];
+            } else if (k >= trailer_at && k < len) {
+                v = trailer[k - trailer_at];
+            }
+            w |= v << (8U * b);
+        }
+        element[2U + i] = w;
+    }
+
+    WRITE_REG(regs->TXBAR, 1UL << put);
+    hfdcan->LatestTxFifoQRequest = 1UL << put;
+    return true;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file mono_clock.c
+ * @brief 64-bit µs monotonic clock: TIM17 counter (low 16 bits) + overflow count (high bits).
+ *
+ * TIM17 runs from the 160 MHz APB2 timer clock with PSC=159, i.e. 1 tick = 1 us,
+ * and ARR=0xFFFF so it wraps every 65.536 ms.
+ */
+
+#include "mono_clock.h"
+#include "tim.h"
+
+#define MONO_CLOCK_HALF_RANGE  0x8000U
+
+static volatile uint32_t s_overflows;
+
+void mono_clock_init(void)
+{
+    s_overflows = 0;
+    __HAL_TIM_SET_COUNTER(&htim17, 0);
+    __HAL_TIM_CLEAR_FLAG(&htim17, TIM_FLAG_UPDATE);
+    HAL_TIM_Base_Start_IT(&htim17);
+}
+
+void mono_clock_isr_overflow(void)
+{
+    s_overflows++;
+}
+
+uint64_t mono_clock_usec(void)
+{
+    uint32_t hi;
+    uint32_t cnt;
+    uint32_t pending;
+    do {
+        hi      = s_overflows;
+        cnt     = __HAL_TIM_GET_COUNTER(&htim17);
+        pending = __HAL_TIM_GET_FLAG(&htim17, TIM_FLAG_UPDATE);
+    } while (hi != s_overflows);
+
+    /* Wrapped but the update IRQ has not run yet (we are in a same/higher priority ISR,
+     * or it is about to be taken). A small count means it was read after the wrap. */
+    if (pending != 0U && cnt < MONO_CLOCK_HALF_RANGE) {
+        hi++;
+    }
+    return ((uint64_t)hi << 16) | (uint64_t)cnt;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file servo_trajectory.c
+ * @brief Per-channel setpoint interpolation with velocity/acceleration limits (single precision, FPU).
+ */
+
+#include "servo_trajectory.h"
+#include "actuator_loop.h"
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define USEC_PER_SEC  1000000.0f
+
+typedef struct {
+    ServoTrajConfig cfg;
+
+    /* Current segment: p0/v0 at seg_start_usec to p1/v1 after seg_duration_usec (0: jump to p1). */
+    float    p0;
+    float    v0;
+    float    p1;
+    float    v1;
+    uint64_t seg_start_usec;
+    uint32_t seg_duration_usec;
+
+    float    last_target;
+    uint64_t last_stamp_usec;
+    bool     has_target;
+
+    /* Output state */
+    float pos;
+    float vel;
+} Channel;
+
+/* Full travel (-1..1) in 0.5 s, reaching that speed in 0.1 s */
+static const ServoTrajConfig kDefaultConfig = { SERVO_TRAJ_LINEAR, 4.0f, 40.0f };
+
+static Channel  s_channels[SERVO_TRAJ_CHANNELS];
+static uint64_t s_last_step_usec;
+
+static float clampf(float v, float lo, float hi)
+{
+    return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+static void reset_channel(Channel* c)
+{
+    const ServoTrajConfig cfg = c->cfg;
+    memset(c, 0, sizeof(*c));
+    c->cfg = cfg;
+}
+
+void servo_trajectory_init(void)
+{
+    for (uint8_t i = 0; i < SERVO_TRAJ_CHANNELS; i++) {
+        s_channels[i].cfg = kDefaultConfig;
+        reset_channel(&s_channels[i]);
+    }
+    s_last_step_usec = 0;
+}
+
+void servo_trajectory_configure(uint8_t channel, const ServoTrajConfig* config)
+{
+    if (channel < SERVO_TRAJ_CHANNELS && config != NULL) {
+        s_channels[channel].cfg = *config;
+    }
+}
+
+void servo_trajectory_reset(void)
+{
+    for (uint8_t i = 0; i < SERVO_TRAJ_CHANNELS; i++) {
+        reset_channel(&s_channels[i]);
+    }
+}
+
+void servo_trajectory_set_target(uint8_t channel, float setpoint, uint64_t stamp_usec)
+{
+    if (channel >= SERVO_TRAJ_CHANNELS) {
+        return;
+    }
+    Channel* const c = &s_channels[channel];
+
+    uint32_t interval = 0;
+    if (c->has_target && stamp_usec > c->last_stamp_usec &&
+        (stamp_usec - c->last_stamp_usec) <= SERVO_TRAJ_MAX_SEGMENT_USEC) {
+        interval = (uint32_t)(stamp_usec - c->last_stamp_usec);
+    }
+
+    c->p0 = c->pos;
+    c->v0 = c->vel;
+    c->p1 = setpoint;
+    c->v1 = 0.0f;
+    if (c->cfg.mode == SERVO_TRAJ_CUBIC && interval > 0U) {
+        c->v1 = (setpoint - c->last_target) * USEC_PER_SEC / (float)interval;
+        if (c->cfg.max_velocity > 0.0f) {
+            c->v1 = clampf(c->v1, -c->cfg.max_velocity, c->cfg.max_velocity);
+        }
+    }
+    c->seg_start_usec    = stamp_usec;
+    c->seg_duration_usec = (c->cfg.mode == SERVO_TRAJ_STEP) ? 0U : interval;
+
+    c->last_target     = setpoint;
+    c->last_stamp_usec = stamp_usec;
+    c->has_target      = true;
+}
+
+/* Interpolated position of the current segment at now_usec. */
+static float segment_position(const Channel* c, uint64_t now_usec)
+{
+    if (c->seg_duration_usec == 0U || now_usec <= c->seg_start_usec) {
+        return (c->seg_duration_usec == 0U) ? c->p1 : c->p0;
+    }
+    const uint64_t elapsed = now_usec - c->seg_start_usec;
+    if (elapsed >= c->seg_duration_usec) {
+        return c->p1;
+    }
+    const float u = (float)elapsed / (float)c->seg_duration_usec;
+    if (c->cfg.mode == SERVO_TRAJ_LINEAR) {
+        return c->p0 + (c->p1 - c->p0) * u;
+    }
+    /* Cubic Hermite; tangents scaled by the segment length in seconds */
+    const float t   = (float)c->seg_duration_usec / USEC_PER_SEC;
+    const float u2  = u * u;
+    const float u3  = u2 * u;
+    const float h00 = 2.0f * u3 - 3.0f * u2 + 1.0f;
+    const float h10 = u3 - 2.0f * u2 + u;
+    const float h01 = -2.0f * u3 + 3.0f * u2;
+    const float h11 = u3 - u2;
+    return h00 * c->p0 + h10 * t * c->v0 + h01 * c->p1 + h11 * t * c->v1;
+}
+
+/* Moves pos toward desired within the velocity/acceleration limits. */
+static void follow(Channel* c, float desired, float dt)
+{
+    const float error = desired - c->pos;
+    float v = error / dt;
+
+    if (c->cfg.max_velocity > 0.0f) {
+        v = clampf(v, -c->cfg.max_velocity, c->cfg.max_velocity);
+    }
+    if (c->cfg.max_acceleration > 0.0f) {
+        /* Never faster than what can still stop exactly at desired when braking by at most a*dt
+         * per step. Stepping at v leaves dt * (v + (v - dv) + ... + (v - m*dv)) to cover, m = floor(v/dv);
+         * solving that for the remaining distance gives the largest such v. (The continuous bound
+         * v^2/(2a) + v*dt/2 is only exact at multiples of dv and made the last braking step exceed a.) */
+        const float a      = c->cfg.max_acceleration;
+        const float dv_max = a * dt;
+        const float span   = fabsf(error) / dt;
+        const float m      = floorf(0.5f * (sqrtf(1.0f + 8.0f * span / dv_max) - 1.0f));
+        const float v_stop = span / (m + 1.0f) + 0.5f * m * dv_max;
+        v = clampf(v, -v_stop, v_stop);
+        v = clampf(v, c->vel - dv_max, c->vel + dv_max);
+        /* Braking wins over the acceleration floor: never step past desired */
+        if ((error >= 0.0f && v > error / dt) || (error < 0.0f && v < error / dt)) {
+            v = error / dt;
+        }
+    }
+
+    c->vel = v;
+    c->pos = clampf(c->pos + v * dt, -1.0f, 1.0f);
+}
+
+void servo_trajectory_step(uint64_t now_usec, float out[SERVO_TRAJ_CHANNELS])
+{
+    const float period = (float)ACTUATOR_LOOP_PERIOD_USEC / USEC_PER_SEC;
+    float dt = period;
+    if (s_last_step_usec != 0U && now_usec > s_last_step_usec) {
+        dt = clampf((float)(now_usec - s_last_step_usec) / USEC_PER_SEC, 0.0f, 2.0f * period);
+    }
+    s_last_step_usec = now_usec;
+
+    for (uint8_t i = 0; i < SERVO_TRAJ_CHANNELS; i++) {
+        Channel* const c = &s_channels[i];
+        follow(c, segment_position(c, now_usec), dt);
+        out[i] = c->pos;
+    }
+}
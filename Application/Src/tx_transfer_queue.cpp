@@ -0,0 +1,208 @@
+/**
+ * @file tx_transfer_queue.cpp
+ * @brief TxTransferQueue 実装: アリーナの予約・回収と Cyphal/CAN のフレーム分割。
+ *
+ * フレームの中身は libcanard の txPushSingleFrame / txGenerateMultiFrameChain と同じになる。
+ * - 単一フレーム（ペイロード 63 バイト以下）: ペイロード、ゼロ詰め、テール（SOT | EOT | toggle=1）。
+ * - マルチフレーム: ペイロード + CRC（上位・下位の順）を 63 バイトずつ送り、最後のフレームだけ
+ *   CRC の前に DLC 長までのゼロ詰めを入れる。CRC はペイロードとゼロ詰めにかかる。toggle は 1 から交互。
+ */
+
+#include "tx_transfer_queue.hpp"
+#include "transfer_crc.h"
+
+namespace {
+
+constexpr uint8_t kTailStart  = 0x80U;
+constexpr uint8_t kTailEnd    = 0x40U;
+constexpr uint8_t kTailToggle = 0x20U;
+constexpr size_t  kCrcBytes   = 2U;
+
+constexpr size_t round8(size_t n) { return (n + 7U) & ~static_cast<size_t>(7U); }
+
+constexpr size_t kHeaderBytes = round8(sizeof(TxTransferQueue::Transfer));
+
+/* DLC で表せる長さに切り上げる（n <= 64） */
+size_t round_to_frame(size_t n)
+{
+    return CanardCANDLCToLength[CanardCANLengthToDLC[n]];
+}
+
+} // namespace
+
+void TxTransferQueue::init()
+{
+    reserved_ = false;
+    Transfer* const b = block_at(0);
+    b->span   = static_cast<uint16_t>(kArenaBytes);
+    b->vacant = true;
+    heads_.fill(nullptr);
+    tails_.fill(nullptr);
+    frames_pending_ = 0;
+}
+
+uint8_t* TxTransferQueue::reserve(size_t max_size)
+{
+    cancel();
+    const size_t need = kHeaderBytes + round8(max_size);
+    if (max_size > UINT16_MAX || need > kArenaBytes) return nullptr;
+
+    /* 先頭から最初に収まる空き。隣り合う空きはここで連結する（回収は pop() で vacant にするだけ） */
+    for (size_t at = 0; at < kArenaBytes; at += block_at(at)->span) {
+        Transfer* const b = block_at(at);
+        if (!b->vacant) continue;
+        while (at + b->span < kArenaBytes && block_at(at + b->span)->vacant) {
+            b->span = static_cast<uint16_t>(b->span + block_at(at + b->span)->span);
+        }
+        if (b->span < need) continue;
+
+        split(at, need);
+        b->vacant = false;
+        res_at_   = at;
+        res_size_ = max_size;
+        reserved_ = true;
+        return &arena_[at + kHeaderBytes];
+    }
+    return nullptr;
+}
+
+bool TxTransferQueue::commit(uint32_t can_id, CanardTransferID transfer_id, size_t size,
+                             CanardMicrosecond now_usec, CanardMicrosecond deadline_usec)
+{
+    if (!reserved_ || size > res_size_) return false;
+    reserved_ = false;
+
+    Transfer* const t = reinterpret_cast<Transfer*>(&arena_[res_at_]);
+    t->next          = nullptr;
+    t->deadline_usec = deadline_usec;
+    t->enqueued_usec = now_usec;
+    t->can_id        = can_id;
+    t->size          = static_cast<uint16_t>(size);
+    t->offset        = 0;
+    t->tail          = static_cast<uint8_t>(kTailToggle | (transfer_id & CANARD_TRANSFER_ID_MAX));
+    /* 最大長で取った予約を実際の長さに縮め、余りは空きに戻す */
+    split(res_at_, kHeaderBytes + round8(size));
+
+    if (size <= kFramePayload) {
+        t->crc     = 0;
+        t->padding = static_cast<uint8_t>(round_to_frame(size + 1U) - (size + 1U));
+    } else {
+        /* 最後のフレームに残る CRC 込みのバイト数から、ゼロ詰めの長さが決まる */
+        static const uint8_t kZeros[CANARD_MTU_CAN_FD] = {};
+        const size_t total = size + kCrcBytes;
+        const size_t last  = total - kFramePayload * ((total - 1U) / kFramePayload);
+        t->padding = static_cast<uint8_t>(round_to_frame(last + 1U) - (last + 1U));
+        uint16_t crc = transfer_crc_add(TRANSFER_CRC_INITIAL, payload_of(t), size);
+        t->crc = transfer_crc_add(crc, kZeros, t->padding);
+    }
+
+    const size_t prio = (can_id >> 26) & (kPriorityCount - 1U);
+    if (tails_[prio] != nullptr) {
+        tails_[prio]->next = t;
+    } else {
+        heads_[prio] = t;
+    }
+    tails_[prio] = t;
+    frames_pending_ += frame_count(size);
+    return true;
+}
+
+void TxTransferQueue::cancel()
+{
+    if (reserved_) block_at(res_at_)->vacant = true;
+    reserved_ = false;
+}
+
+TxTransferQueue::Transfer* TxTransferQueue::front() const
+{
+    for (Transfer* t : heads_) {
+        if (t != nullptr) return t;
+    }
+    return nullptr;
+}
+
+TxTransferQueue::Frame TxTransferQueue::next_frame(const Transfer& t) const
+{
+    const size_t total = (t.size > kFramePayload) ? t.size + kCrcBytes : t.size;
+    const size_t begin = t.offset;
+    const size_t rem   = total - begin;
+    const bool   last  = (rem <= kFramePayload);
+    const size_t end   = begin + (last ? rem : kFramePayload);
+
+    Frame f{};
+    f.can_id = t.can_id;
+    f.size   = static_cast<uint8_t>(last ? (end - begin) + t.padding + 1U : CANARD_MTU_CAN_FD);
+    if (begin < t.size) {
+        f.payload      = payload_of(&t) + begin;
+        f.payload_size = static_cast<uint8_t>(((end < t.size) ? end : t.size) - begin);
+    }
+    /* 通し位置 size が CRC 上位、size + 1 が下位 */
+    for (size_t i = (begin > t.size) ? begin : t.size; i < end; ++i) {
+        f.trailer[f.trailer_size++] = static_cast<uint8_t>((i == t.size) ? (t.crc >> 8) : t.crc);
+    }
+    f.trailer[f.trailer_size++] = static_cast<uint8_t>(
+        ((begin == 0U) ? kTailStart : 0U) | (last ? kTailEnd : 0U) | t.tail);
+    return f;
+}
+
+bool TxTransferQueue::advance(Transfer& t)
+{
+    const size_t total = (t.size > kFramePayload) ? t.size + kCrcBytes : t.size;
+    const size_t rem   = total - t.offset;
+    frames_pending_--;
+    if (rem <= kFramePayload) {
+        pop(t);
+        return true;
+    }
+    t.offset = static_cast<uint16_t>(t.offset + kFramePayload);
+    t.tail   = static_cast<uint8_t>(t.tail ^ kTailToggle);
+    return false;
+}
+
+uint32_t TxTransferQueue::drop(Transfer& t)
+{
+    const uint32_t left = static_cast<uint32_t>(frame_count(t.size) - t.offset / kFramePayload);
+    frames_pending_ -= left;
+    pop(t);
+    return left;
+}
+
+size_t TxTransferQueue::frame_count(size_t size)
+{
+    if (size <= kFramePayload) return 1U;
+    return (size + kCrcBytes + kFramePayload - 1U) / kFramePayload;
+}
+
+uint8_t* TxTransferQueue::payload_of(Transfer* t)
+{
+    return reinterpret_cast<uint8_t*>(t) + kHeaderBytes;
+}
+
+const uint8_t* TxTransferQueue::payload_of(const Transfer* t)
+{
+    return reinterpret_cast<const uint8_t*>(t) + kHeaderBytes;
+}
+
+TxTransferQueue::Transfer* TxTransferQueue::block_at(size_t offset)
+{
+    return reinterpret_cast<Transfer*>(&arena_[offset]);
+}
+
+/* offset のブロックを先頭 span バイトに縮め、残りを空きブロックにする（ヘッダが置けない端数は付けたまま） */
+void TxTransferQueue::split(size_t offset, size_t span)
+{
+    Transfer* const b = block_at(offset);
+    if (b->span < span + kHeaderBytes) return;
+    Transfer* const rest = block_at(offset + span);
+    rest->span   = static_cast<uint16_t>(b->span - span);
+    rest->vacant = true;
+    b->span      = static_cast<uint16_t>(span);
+}
+
+void TxTransferQueue::pop(Transfer& t)
+{
+    const size_t prio = (t.can_id >> 26) & (kPriorityCount - 1U);
+    heads_[prio] = t.next;
+    if (heads_[prio] == nullptr) tails_[prio] = nullptr;
+    t.vacant = true;
+}
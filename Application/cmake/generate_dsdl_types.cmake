@@ -7,6 +7,12 @@
 # Usage:
 #   include(Application/cmake/generate_dsdl_types.cmake)
 #
+# The headers are added to DSDL_TYPES_TARGET (default: ${CMAKE_PROJECT_NAME}).
+#
+
+if(NOT DEFINED DSDL_TYPES_TARGET)
+    set(DSDL_TYPES_TARGET ${CMAKE_PROJECT_NAME})
+endif()
 
 find_package(Python3 REQUIRED)
 set(PYTHON_VENV_DIR "${CMAKE_CURRENT_BINARY_DIR}/.venv")
@@ -66,5 +72,5 @@ add_custom_command(
 add_custom_target(dsdl_types ALL DEPENDS "${DSDL_TYPES_STAMP}")
 
 # Make generated headers visible to all source files in the project.
-target_include_directories(${CMAKE_PROJECT_NAME} PRIVATE "${DSDL_TYPES_DIR}")
-add_dependencies(${CMAKE_PROJECT_NAME} dsdl_types)
+target_include_directories(${DSDL_TYPES_TARGET} PRIVATE "${DSDL_TYPES_DIR}")
+add_dependencies(${DSDL_TYPES_TARGET} dsdl_types)
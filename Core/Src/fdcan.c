@@ -53,14 +53,15 @@ void MX_FDCAN1_Init(void)
   hfdcan1.Init.DataTimeSeg1 = 25;
   hfdcan1.Init.DataTimeSeg2 = 6;
   hfdcan1.Init.StdFiltersNbr = 0;
-  hfdcan1.Init.ExtFiltersNbr = 1;
-  hfdcan1.Init.TxFifoQueueMode = FDCAN_TX_FIFO_OPERATION;
+  hfdcan1.Init.ExtFiltersNbr = 8;
+  hfdcan1.Init.TxFifoQueueMode = FDCAN_TX_QUEUE_OPERATION;
   if (HAL_FDCAN_Init(&hfdcan1) != HAL_OK)
   {
     Error_Handler();
   }
   /* USER CODE BEGIN FDCAN1_Init 2 */
-  /* Accept all extended IDs into RX FIFO0 (Cyphal uses extended IDs; libcanard filters by subject). */
+  /* Accept all extended IDs into RX FIFO0 until CyphalTransport::start_fdcan() programs the */
+  /* extended filter elements from its subscription table (Cyphal uses extended IDs only). */
   /* Reject non-matching standard IDs and all remote frames. */
   if (HAL_FDCAN_ConfigGlobalFilter(&hfdcan1,
                                    FDCAN_REJECT,              /* NonMatchingStd */
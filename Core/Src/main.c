@@ -18,6 +18,7 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "dma.h"
 #include "fdcan.h"
 #include "tim.h"
 #include "gpio.h"
@@ -32,6 +33,11 @@
 #include "led_blink_node.h"
 #include "cyphal_node.h"
 #include "actuator_command.h"
+#include "actuator_loop.h"
+#include "mono_clock.h"
+#if USAGI_BENCH
+#include "cyphal_bench.h"
+#endif
 
 /* USER CODE END Includes */
 
@@ -98,15 +104,19 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_FDCAN1_Init();
   MX_TIM1_Init();
   MX_TIM2_Init();
   MX_TIM17_Init();
   /* USER CODE BEGIN 2 */
+  mono_clock_init();
   if (!cyphal_node_init()) {
     Error_Handler();
   }
+#if !USAGI_BENCH
   actuator_command_init();
+#endif
   /* USER CODE END 2 */
 
   /* Initialize leds */
@@ -125,8 +135,15 @@ int main(void)
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
+#if USAGI_BENCH
+  /* Benchmark build: JSON results on COM1, so no LED task writing to the same UART */
+  xTaskCreate(CyphalBenchTask, "CyphalBench", configMINIMAL_STACK_SIZE*6, NULL, 2, NULL);
+#else
   xTaskCreate(LEDBlinkTask, "LedBlink", configMINIMAL_STACK_SIZE*1, NULL, 1, NULL);
   xTaskCreate(CyphalControlTask, "CyphalCtrl", configMINIMAL_STACK_SIZE*4, NULL, 2, NULL);
+  /* Above CyphalCtrl: actuation runs on the servo PWM period, independent of RX load */
+  xTaskCreate(ActuatorTask, "Actuator", configMINIMAL_STACK_SIZE*2, NULL, 3, NULL);
+#endif
   vTaskStartScheduler();
 
   while (1)
@@ -213,6 +230,14 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
+  else if (htim->Instance == TIM17)
+  {
+    mono_clock_isr_overflow();
+  }
+  else if (htim->Instance == TIM2)
+  {
+    actuator_loop_isr_period();
+  }
 
   /* USER CODE END Callback 1 */
 }
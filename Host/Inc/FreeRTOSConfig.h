@@ -0,0 +1,92 @@
+/**
+ * @file FreeRTOSConfig.h
+ * @brief FreeRTOS configuration for the host build (GCC_POSIX port, heap_4).
+ *
+ * Scheduling-relevant settings (tick rate, priorities, preemption, notifications) match
+ * Core/Inc/FreeRTOSConfig.h so tick-based timeouts behave as on the target. Tasks created
+ * on the host need a stack of at least PTHREAD_STACK_MIN bytes.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configTICK_RATE_HZ                         100
+#define configUSE_PREEMPTION                       1
+#define configUSE_TIME_SLICING                     0
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION    0
+#define configUSE_TICKLESS_IDLE                    0
+#define configMAX_PRIORITIES                       5
+#define configMINIMAL_STACK_SIZE                   ( ( unsigned short ) 4096 )
+#define configMAX_TASK_NAME_LEN                    16
+#define configTICK_TYPE_WIDTH_IN_BITS              TICK_TYPE_WIDTH_32_BITS
+#define configIDLE_SHOULD_YIELD                    1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES      1
+#define configQUEUE_REGISTRY_SIZE                  0
+#define configENABLE_BACKWARD_COMPATIBILITY        0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS    0
+#define configSTACK_DEPTH_TYPE                     size_t
+#define configMESSAGE_BUFFER_LENGTH_TYPE           size_t
+#define configUSE_NEWLIB_REENTRANT                 0
+
+#define configUSE_TIMERS                           0
+#define configUSE_EVENT_GROUPS                     1
+#define configUSE_STREAM_BUFFERS                   1
+
+#define configSUPPORT_STATIC_ALLOCATION            0
+#define configSUPPORT_DYNAMIC_ALLOCATION           1
+#define configTOTAL_HEAP_SIZE                      ( 1024 * 1024 )
+
+#define configUSE_IDLE_HOOK                        0
+#define configUSE_TICK_HOOK                        0
+#define configUSE_MALLOC_FAILED_HOOK               0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK         0
+#define configCHECK_FOR_STACK_OVERFLOW             0
+
+#define configGENERATE_RUN_TIME_STATS              1
+#define configRUN_TIME_COUNTER_TYPE                uint64_t
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint64_t mono_clock_usec( void );  /* Host/Src/mono_clock_host.c */
+#ifdef __cplusplus
+}
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()           mono_clock_usec()
+#define configUSE_TRACE_FACILITY                   1
+#define configUSE_STATS_FORMATTING_FUNCTIONS       0
+
+#define configUSE_CO_ROUTINES                      0
+#define configMAX_CO_ROUTINE_PRIORITIES            1
+
+#define configASSERT( x )                          assert( x )
+
+#define configUSE_TASK_NOTIFICATIONS               1
+#define configUSE_MUTEXES                          1
+#define configUSE_RECURSIVE_MUTEXES                1
+#define configUSE_COUNTING_SEMAPHORES              1
+#define configUSE_QUEUE_SETS                       0
+#define configUSE_APPLICATION_TASK_TAG             0
+
+#define INCLUDE_vTaskPrioritySet                   1
+#define INCLUDE_uxTaskPriorityGet                  1
+#define INCLUDE_vTaskDelete                        1
+#define INCLUDE_vTaskSuspend                       1
+#define INCLUDE_xResumeFromISR                     1
+#define INCLUDE_vTaskDelayUntil                    1
+#define INCLUDE_vTaskDelay                         1
+#define INCLUDE_xTaskGetSchedulerState             1
+#define INCLUDE_xTaskGetCurrentTaskHandle          1
+#define INCLUDE_uxTaskGetStackHighWaterMark        1
+#define INCLUDE_xTaskGetIdleTaskHandle             0
+#define INCLUDE_eTaskGetState                      0
+#define INCLUDE_xEventGroupSetBitFromISR           1
+#define INCLUDE_xTimerPendFunctionCall             0
+#define INCLUDE_xTaskAbortDelay                    0
+#define INCLUDE_xTaskGetHandle                     0
+#define INCLUDE_xTaskResumeFromISR                 1
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,24 @@
+/**
+ * @file fdcan.h
+ * @brief Host shim of Core/Inc/fdcan.h. The controller is simulated in hal_fdcan_host.c.
+ */
+
+#ifndef __FDCAN_H__
+#define __FDCAN_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+extern FDCAN_HandleTypeDef hfdcan1;
+
+/** Same controller configuration as the CubeMX-generated MX_FDCAN1_Init (filters, global filter). */
+void MX_FDCAN1_Init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FDCAN_H__ */
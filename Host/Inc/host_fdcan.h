@@ -0,0 +1,59 @@
+/**
+ * @file host_fdcan.h
+ * @brief Bus side of the simulated FDCAN1 controller (host build only).
+ *
+ * host_fdcan_receive() plays a frame arriving from the bus: it runs the extended filter
+ * elements and the global filter, stores the frame in the 3-element RX FIFO0 and raises
+ * the RX FIFO0 interrupt. host_fdcan_transmit() completes the pending TX buffer that wins
+ * arbitration (FIFO order, or lowest CAN ID in queue mode) and raises the
+ * transmission-complete interrupt.
+ *
+ * "Interrupts" run synchronously in the caller, so both functions must be called from a
+ * FreeRTOS task (POSIX port) — the same rule as any *FromISR API on this port.
+ */
+
+#ifndef HOST_FDCAN_H
+#define HOST_FDCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HOST_FDCAN_RX_FIFO_DEPTH  3U   /* G4 RX FIFO0 elements */
+#define HOST_FDCAN_TX_FIFO_DEPTH  3U   /* G4 TX buffers */
+#define HOST_FDCAN_MTU            64U
+
+typedef struct {
+    uint32_t extended_can_id;
+    uint8_t  size;                     /* bytes, rounded up to a valid CAN FD length */
+    uint8_t  data[HOST_FDCAN_MTU];
+} HostCanFrame;
+
+typedef struct {
+    uint32_t rx_accepted;              /* stored in RX FIFO0 */
+    uint32_t rx_filtered;              /* rejected by the filter elements / global filter */
+    uint32_t rx_lost;                  /* RX FIFO0 full (blocking mode: new frame is lost) */
+    uint32_t tx_sent;
+    uint32_t tx_reordered;             /* sent ahead of an older pending frame with the same CAN ID */
+} HostFdcanStats;
+
+/** Delivers a frame from the bus. Returns true if it was stored in RX FIFO0. */
+bool host_fdcan_receive(const HostCanFrame* frame);
+
+/** Takes the next pending TX frame onto the bus. Returns false if none is pending. */
+bool host_fdcan_transmit(HostCanFrame* out);
+
+/** Number of TX buffers with a pending transmission request. */
+size_t host_fdcan_tx_pending(void);
+
+void host_fdcan_get_stats(HostFdcanStats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_FDCAN_H */
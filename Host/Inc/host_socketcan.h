@@ -0,0 +1,36 @@
+/**
+ * @file host_socketcan.h
+ * @brief Connects the simulated FDCAN1 (host_fdcan.h) to a Linux SocketCAN FD interface.
+ *
+ * Frames read from the socket enter through host_fdcan_receive(), i.e. through the same
+ * filters, RX FIFO0 and isr_rx() as on the target; frames queued by flush_tx() leave
+ * through host_fdcan_transmit(). CyphalTransport itself is unchanged.
+ *
+ * A local virtual bus is enough:
+ *   ip link add dev vcan0 type vcan && ip link set vcan0 mtu 72 && ip link set up vcan0
+ */
+
+#ifndef HOST_SOCKETCAN_H
+#define HOST_SOCKETCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+/** Opens a CAN FD raw socket bound to ifname (e.g. "vcan0"). Call before the scheduler starts. */
+bool host_socketcan_open(const char* ifname);
+
+/**
+ * FreeRTOS task: moves frames between the socket and the simulated controller.
+ * Create it below CyphalControlTask's priority; the RX "interrupt" then preempts it as
+ * soon as it notifies the task. pvParameters: unused.
+ */
+void HostSocketCanTask(void* pvParameters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SOCKETCAN_H */
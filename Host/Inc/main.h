@@ -0,0 +1,22 @@
+/**
+ * @file main.h
+ * @brief Host shim of Core/Inc/main.h: HAL shim + Error_Handler.
+ */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32g4xx_hal.h"
+
+/** Aborts the host process (the target spins with interrupts disabled). */
+void Error_Handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
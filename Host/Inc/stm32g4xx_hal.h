@@ -0,0 +1,326 @@
+/**
+ * @file stm32g4xx_hal.h
+ * @brief Host shim of the STM32G4 HAL subset used by Application/ (FDCAN, TIM, GPIO, DWT).
+ *
+ * Types, field order and constant values follow the real G4 HAL so that Application
+ * sources compile unchanged. Peripheral "registers" are plain structs in host memory;
+ * the FDCAN controller is simulated in hal_fdcan_host.c (bus side: host_fdcan.h).
+ */
+
+#ifndef STM32G4XX_HAL_H
+#define STM32G4XX_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define __IO volatile
+
+/* CMSIS register access. Writes go through the shim so that registers with side effects
+ * (FDCAN RXF0A / TXBAR) act on the simulated controller; other registers are plain stores. */
+void host_write_reg(volatile uint32_t* reg, uint32_t value);
+
+#define READ_REG(REG)         ((REG))
+#define WRITE_REG(REG, VAL)   host_write_reg(&(REG), (VAL))
+
+typedef enum {
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum { DISABLE = 0U, ENABLE = !DISABLE } FunctionalState;
+
+/* ----------------------------------------------------------------------- */
+/* Cortex-M4 debug: DWT cycle counter                                       */
+/* ----------------------------------------------------------------------- */
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+/** Refreshes CYCCNT from the host monotonic clock (1 count = 1 ns) and returns the block. */
+DWT_Type* host_dwt(void);
+extern CoreDebug_Type host_core_debug;
+
+#define DWT        (host_dwt())
+#define CoreDebug  (&host_core_debug)
+
+/* ----------------------------------------------------------------------- */
+/* GPIO                                                                     */
+/* ----------------------------------------------------------------------- */
+
+typedef struct {
+    __IO uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef enum { GPIO_PIN_RESET = 0U, GPIO_PIN_SET } GPIO_PinState;
+
+#define GPIO_PIN_0   ((uint16_t)0x0001)
+#define GPIO_PIN_1   ((uint16_t)0x0002)
+#define GPIO_PIN_5   ((uint16_t)0x0020)
+
+extern GPIO_TypeDef host_gpioa;
+extern GPIO_TypeDef host_gpiob;
+extern GPIO_TypeDef host_gpiof;
+
+#define GPIOA  (&host_gpioa)
+#define GPIOB  (&host_gpiob)
+#define GPIOF  (&host_gpiof)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+
+/* ----------------------------------------------------------------------- */
+/* TIM                                                                      */
+/* ----------------------------------------------------------------------- */
+
+typedef struct {
+    __IO uint32_t CR1;
+    __IO uint32_t DIER;
+    __IO uint32_t SR;
+    __IO uint32_t CNT;
+    __IO uint32_t PSC;
+    __IO uint32_t ARR;
+    __IO uint32_t CCR1;
+    __IO uint32_t CCR2;
+    __IO uint32_t CCR3;
+    __IO uint32_t CCR4;
+} TIM_TypeDef;
+
+typedef struct {
+    TIM_TypeDef* Instance;
+} TIM_HandleTypeDef;
+
+extern TIM_TypeDef host_tim1;
+extern TIM_TypeDef host_tim2;
+extern TIM_TypeDef host_tim17;
+
+#define TIM1   (&host_tim1)
+#define TIM2   (&host_tim2)
+#define TIM17  (&host_tim17)
+
+#define TIM_CHANNEL_1    0x00000000U
+#define TIM_CHANNEL_2    0x00000004U
+#define TIM_CHANNEL_3    0x00000008U
+#define TIM_CHANNEL_4    0x0000000CU
+#define TIM_FLAG_UPDATE  (1UL << 0)
+#define TIM_IT_UPDATE    (1UL << 0)
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+    (*(&((__HANDLE__)->Instance->CCR1) + ((__CHANNEL__) >> 2U)) = (__COMPARE__))
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__) \
+    (*(&((__HANDLE__)->Instance->CCR1) + ((__CHANNEL__) >> 2U)))
+#define __HAL_TIM_SET_COUNTER(__HANDLE__, __COUNTER__)  ((__HANDLE__)->Instance->CNT = (__COUNTER__))
+#define __HAL_TIM_GET_COUNTER(__HANDLE__)               ((__HANDLE__)->Instance->CNT)
+#define __HAL_TIM_GET_FLAG(__HANDLE__, __FLAG__)        (((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__))
+#define __HAL_TIM_CLEAR_FLAG(__HANDLE__, __FLAG__)      ((__HANDLE__)->Instance->SR = ~(uint32_t)(__FLAG__))
+#define __HAL_TIM_ENABLE_IT(__HANDLE__, __INTERRUPT__)  ((__HANDLE__)->Instance->DIER |= (__INTERRUPT__))
+#define __HAL_TIM_DISABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->DIER &= ~(__INTERRUPT__))
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t Channel);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim);
+
+/* ----------------------------------------------------------------------- */
+/* FDCAN                                                                    */
+/* ----------------------------------------------------------------------- */
+
+typedef struct {
+    __IO uint32_t IR;      /* interrupt flags (RF0N, TC, ...) */
+    __IO uint32_t IE;      /* interrupt enables */
+    __IO uint32_t RXF0S;   /* RX FIFO0 status: fill level, get / put index, full */
+    __IO uint32_t RXF0A;   /* RX FIFO0 acknowledge (write-only: releases up to this index) */
+    __IO uint32_t TXFQS;   /* TX FIFO/queue status: free level, put index, full */
+    __IO uint32_t TXBRP;   /* per-buffer transmission request pending */
+    __IO uint32_t TXBAR;   /* per-buffer add request (write-only: sets TXBRP) */
+    __IO uint32_t TXBTIE;  /* per-buffer transmission complete enables */
+} FDCAN_GlobalTypeDef;
+
+#define FDCAN_RXF0S_F0FL_Pos        (0U)
+#define FDCAN_RXF0S_F0FL            (0xFUL << FDCAN_RXF0S_F0FL_Pos)
+#define FDCAN_RXF0S_F0GI_Pos        (8U)
+#define FDCAN_RXF0S_F0GI            (0x3UL << FDCAN_RXF0S_F0GI_Pos)
+#define FDCAN_RXF0S_F0PI_Pos        (16U)
+#define FDCAN_RXF0S_F0PI            (0x3UL << FDCAN_RXF0S_F0PI_Pos)
+#define FDCAN_RXF0S_F0F_Pos         (24U)
+#define FDCAN_RXF0S_F0F             (0x1UL << FDCAN_RXF0S_F0F_Pos)
+
+#define FDCAN_TXFQS_TFFL_Pos        (0U)
+#define FDCAN_TXFQS_TFFL            (0x7UL << FDCAN_TXFQS_TFFL_Pos)
+#define FDCAN_TXFQS_TFGI_Pos        (8U)
+#define FDCAN_TXFQS_TFGI            (0x3UL << FDCAN_TXFQS_TFGI_Pos)
+#define FDCAN_TXFQS_TFQPI_Pos       (16U)
+#define FDCAN_TXFQS_TFQPI           (0x3UL << FDCAN_TXFQS_TFQPI_Pos)
+#define FDCAN_TXFQS_TFQF_Pos        (21U)
+#define FDCAN_TXFQS_TFQF            (0x1UL << FDCAN_TXFQS_TFQF_Pos)
+
+extern FDCAN_GlobalTypeDef host_fdcan1_regs;
+#define FDCAN1  (&host_fdcan1_regs)
+
+typedef enum {
+    HAL_FDCAN_STATE_RESET = 0x00U,
+    HAL_FDCAN_STATE_READY = 0x01U,
+    HAL_FDCAN_STATE_BUSY  = 0x02U,
+    HAL_FDCAN_STATE_ERROR = 0x03U
+} HAL_FDCAN_StateTypeDef;
+
+typedef struct {
+    uint32_t FrameFormat;
+    uint32_t Mode;
+    FunctionalState AutoRetransmission;
+    uint32_t StdFiltersNbr;
+    uint32_t ExtFiltersNbr;
+    uint32_t TxFifoQueueMode;
+} FDCAN_InitTypeDef;
+
+/* Start addresses of the message RAM sections. uint32_t on the G4; uintptr_t here because
+ * the host image lives above 4 GiB. */
+typedef struct {
+    uintptr_t StandardFilterSA;
+    uintptr_t ExtendedFilterSA;
+    uintptr_t RxFIFO0SA;
+    uintptr_t RxFIFO1SA;
+    uintptr_t TxEventFIFOSA;
+    uintptr_t TxFIFOQSA;
+} FDCAN_MsgRamAddressTypeDef;
+
+typedef struct {
+    FDCAN_GlobalTypeDef*            Instance;
+    FDCAN_InitTypeDef               Init;
+    FDCAN_MsgRamAddressTypeDef      msgRam;
+    __IO HAL_FDCAN_StateTypeDef     State;
+    __IO uint32_t                   ErrorCode;
+    uint32_t                        LatestTxFifoQRequest;
+} FDCAN_HandleTypeDef;
+
+typedef struct {
+    uint32_t IdType;
+    uint32_t FilterIndex;
+    uint32_t FilterType;
+    uint32_t FilterConfig;
+    uint32_t FilterID1;
+    uint32_t FilterID2;
+} FDCAN_FilterTypeDef;
+
+typedef struct {
+    uint32_t Identifier;
+    uint32_t IdType;
+    uint32_t TxFrameType;
+    uint32_t DataLength;
+    uint32_t ErrorStateIndicator;
+    uint32_t BitRateSwitch;
+    uint32_t FDFormat;
+    uint32_t TxEventFifoControl;
+    uint32_t MessageMarker;
+} FDCAN_TxHeaderTypeDef;
+
+typedef struct {
+    uint32_t Identifier;
+    uint32_t IdType;
+    uint32_t RxFrameType;
+    uint32_t DataLength;
+    uint32_t ErrorStateIndicator;
+    uint32_t BitRateSwitch;
+    uint32_t FDFormat;
+    uint32_t RxTimestamp;
+    uint32_t FilterIndex;
+    uint32_t IsFilterMatchingFrame;
+} FDCAN_RxHeaderTypeDef;
+
+#define FDCAN_FRAME_FD_BRS          ((uint32_t)0x00000300U)
+#define FDCAN_MODE_NORMAL           ((uint32_t)0x00000000U)
+#define FDCAN_TX_FIFO_OPERATION     ((uint32_t)0x00000000U)
+#define FDCAN_TX_QUEUE_OPERATION    ((uint32_t)0x01000000U)
+
+#define FDCAN_STANDARD_ID           ((uint32_t)0x00000000U)
+#define FDCAN_EXTENDED_ID           ((uint32_t)0x40000000U)
+#define FDCAN_DATA_FRAME            ((uint32_t)0x00000000U)
+#define FDCAN_REMOTE_FRAME          ((uint32_t)0x20000000U)
+#define FDCAN_ESI_ACTIVE            ((uint32_t)0x00000000U)
+#define FDCAN_BRS_OFF               ((uint32_t)0x00000000U)
+#define FDCAN_BRS_ON                ((uint32_t)0x00100000U)
+#define FDCAN_CLASSIC_CAN           ((uint32_t)0x00000000U)
+#define FDCAN_FD_CAN                ((uint32_t)0x00200000U)
+#define FDCAN_NO_TX_EVENTS          ((uint32_t)0x00000000U)
+
+#define FDCAN_FILTER_RANGE          ((uint32_t)0x00000000U)
+#define FDCAN_FILTER_DUAL           ((uint32_t)0x00000001U)
+#define FDCAN_FILTER_MASK           ((uint32_t)0x00000002U)
+#define FDCAN_FILTER_DISABLE        ((uint32_t)0x00000000U)
+#define FDCAN_FILTER_TO_RXFIFO0     ((uint32_t)0x00000001U)
+#define FDCAN_FILTER_TO_RXFIFO1     ((uint32_t)0x00000002U)
+#define FDCAN_FILTER_REJECT         ((uint32_t)0x00000003U)
+
+#define FDCAN_ACCEPT_IN_RX_FIFO0    ((uint32_t)0x00000000U)
+#define FDCAN_ACCEPT_IN_RX_FIFO1    ((uint32_t)0x00000001U)
+#define FDCAN_REJECT                ((uint32_t)0x00000002U)
+#define FDCAN_FILTER_REMOTE         ((uint32_t)0x00000000U)
+#define FDCAN_REJECT_REMOTE         ((uint32_t)0x00000001U)
+
+#define FDCAN_TX_BUFFER0            ((uint32_t)0x00000001U)
+#define FDCAN_TX_BUFFER1            ((uint32_t)0x00000002U)
+#define FDCAN_TX_BUFFER2            ((uint32_t)0x00000004U)
+#define FDCAN_RX_FIFO0              ((uint32_t)0x00000040U)
+
+#define FDCAN_IR_RF0N               (1UL << 0)
+#define FDCAN_IR_TC                 (1UL << 7)
+#define FDCAN_IR_TFE                (1UL << 9)
+#define FDCAN_IE_RF0NE              (1UL << 0)
+#define FDCAN_IE_TCE                (1UL << 7)
+#define FDCAN_IE_TFEE               (1UL << 9)
+
+#define FDCAN_FLAG_RX_FIFO0_NEW_MESSAGE  FDCAN_IR_RF0N
+#define FDCAN_FLAG_TX_COMPLETE           FDCAN_IR_TC
+#define FDCAN_FLAG_TX_FIFO_EMPTY         FDCAN_IR_TFE
+#define FDCAN_IT_RX_FIFO0_NEW_MESSAGE    FDCAN_IE_RF0NE
+#define FDCAN_IT_TX_COMPLETE             FDCAN_IE_TCE
+#define FDCAN_IT_TX_FIFO_EMPTY           FDCAN_IE_TFEE
+
+#define FDCAN_ERROR_NOT_READY       ((uint32_t)0x00000002U)
+#define FDCAN_ERROR_NOT_STARTED     ((uint32_t)0x00000004U)
+#define FDCAN_ERROR_PARAM           ((uint32_t)0x00000010U)
+#define FDCAN_ERROR_FIFO_EMPTY      ((uint32_t)0x00000080U)
+#define FDCAN_ERROR_FIFO_FULL       ((uint32_t)0x00000100U)
+
+#define __HAL_FDCAN_ENABLE_IT(__HANDLE__, __INTERRUPT__)    ((__HANDLE__)->Instance->IE |= (__INTERRUPT__))
+#define __HAL_FDCAN_DISABLE_IT(__HANDLE__, __INTERRUPT__)   ((__HANDLE__)->Instance->IE &= ~(__INTERRUPT__))
+#define __HAL_FDCAN_GET_FLAG(__HANDLE__, __FLAG__)          ((__HANDLE__)->Instance->IR & (__FLAG__))
+#define __HAL_FDCAN_CLEAR_FLAG(__HANDLE__, __FLAG__)        ((__HANDLE__)->Instance->IR &= ~(__FLAG__))
+#define __HAL_FDCAN_GET_IT_SOURCE(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->IE & (__INTERRUPT__))
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigFilter(FDCAN_HandleTypeDef* hfdcan, const FDCAN_FilterTypeDef* sFilterConfig);
+HAL_StatusTypeDef HAL_FDCAN_ConfigGlobalFilter(FDCAN_HandleTypeDef* hfdcan, uint32_t NonMatchingStd,
+                                               uint32_t NonMatchingExt, uint32_t RejectRemoteStd,
+                                               uint32_t RejectRemoteExt);
+HAL_StatusTypeDef HAL_FDCAN_ActivateNotification(FDCAN_HandleTypeDef* hfdcan, uint32_t ActiveITs,
+                                                 uint32_t BufferIndexes);
+HAL_StatusTypeDef HAL_FDCAN_Start(FDCAN_HandleTypeDef* hfdcan);
+HAL_StatusTypeDef HAL_FDCAN_AddMessageToTxFifoQ(FDCAN_HandleTypeDef* hfdcan,
+                                                const FDCAN_TxHeaderTypeDef* pTxHeader,
+                                                const uint8_t* pTxData);
+HAL_StatusTypeDef HAL_FDCAN_GetRxMessage(FDCAN_HandleTypeDef* hfdcan, uint32_t RxLocation,
+                                         FDCAN_RxHeaderTypeDef* pRxHeader, uint8_t* pRxData);
+uint32_t HAL_FDCAN_GetTxFifoFreeLevel(const FDCAN_HandleTypeDef* hfdcan);
+uint32_t HAL_FDCAN_GetLatestTxFifoQRequestBuffer(const FDCAN_HandleTypeDef* hfdcan);
+uint32_t HAL_FDCAN_IsTxBufferMessagePending(const FDCAN_HandleTypeDef* hfdcan, uint32_t TxBufferIndex);
+
+void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef* hfdcan, uint32_t RxFifo0ITs);
+void HAL_FDCAN_TxBufferCompleteCallback(FDCAN_HandleTypeDef* hfdcan, uint32_t BufferIndexes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32G4XX_HAL_H */
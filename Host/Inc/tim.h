@@ -0,0 +1,27 @@
+/**
+ * @file tim.h
+ * @brief Host shim of Core/Inc/tim.h. Compare/counter registers are plain memory.
+ */
+
+#ifndef __TIM_H__
+#define __TIM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "main.h"
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim2;
+extern TIM_HandleTypeDef htim17;
+
+void MX_TIM1_Init(void);
+void MX_TIM2_Init(void);
+void MX_TIM17_Init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIM_H__ */
@@ -0,0 +1,476 @@
+/**
+ * @file hal_fdcan_host.c
+ * @brief Simulated FDCAN1: filter elements, RX FIFO0, TX FIFO/queue and their interrupts.
+ *
+ * Only the behaviour Application/ relies on is modelled: extended-ID filter elements
+ * (first match wins), the global non-matching filter, a blocking 3-element RX FIFO0,
+ * 3 TX buffers and the RF0N / TC interrupt flags and enables.
+ *
+ * RX FIFO0 and the TX buffers live in a message RAM image with the G4 layout (SRAMCAN:
+ * 18-word elements, 2 header words + 64 data bytes), published through hfdcan1.msgRam, and
+ * RXF0S / TXFQS are kept up to date. Writes to RXF0A and TXBAR through WRITE_REG release
+ * RX elements and request transmissions, so fdcan_fast.c runs against the shim unchanged.
+ * Filter elements are kept decoded; their section of the image is unused.
+ *
+ * The TX buffers follow Init.TxFifoQueueMode like the G4: in FIFO mode they are served in
+ * the order they were requested; in queue mode a request takes the lowest free buffer and
+ * the pending buffer with the lowest CAN ID goes first, ties going to the lowest buffer
+ * index (not the oldest request).
+ */
+
+#include "fdcan.h"
+#include "host_fdcan.h"
+#include <string.h>
+
+#define EXT_FILTERS_MAX  8U
+
+typedef struct {
+    uint32_t config;
+    uint32_t type;
+    uint32_t id1;
+    uint32_t id2;
+} ExtFilter;
+
+/* SRAMCAN layout of one FDCAN instance, in words (RM0440) */
+#define MSG_RAM_FLS_WORDS  0U             /* 28 standard filter elements x 1 word */
+#define MSG_RAM_FLE_WORDS  28U            /*  8 extended filter elements x 2 words */
+#define MSG_RAM_RF0_WORDS  44U            /*  3 RX FIFO0 elements x 18 words */
+#define MSG_RAM_RF1_WORDS  98U            /*  3 RX FIFO1 elements x 18 words */
+#define MSG_RAM_EF_WORDS   152U           /*  3 TX event FIFO elements x 2 words */
+#define MSG_RAM_TB_WORDS   158U           /*  3 TX buffers x 18 words */
+#define MSG_RAM_WORDS      212U
+#define ELEMENT_WORDS      18U
+#define ELEMENT_ID_MASK    0x1FFFFFFFUL   /* W0: extended identifier */
+#define ELEMENT_DLC_POS    16U            /* W1: DLC[19:16] */
+
+FDCAN_GlobalTypeDef host_fdcan1_regs;
+FDCAN_HandleTypeDef hfdcan1;
+
+static ExtFilter    s_ext_filters[EXT_FILTERS_MAX];
+static uint32_t     s_non_matching_ext = FDCAN_ACCEPT_IN_RX_FIFO0;
+
+static uint32_t     s_msg_ram[MSG_RAM_WORDS];
+
+static uint32_t     s_rx_get;
+static uint32_t     s_rx_fill;
+
+static uint32_t     s_tx_seq_of[HOST_FDCAN_TX_FIFO_DEPTH];  /* request order, for FIFO mode and the reorder check */
+static uint32_t     s_tx_put;              /* FIFO mode put index */
+static uint32_t     s_tx_seq;
+
+static HostFdcanStats s_stats;
+
+static const uint8_t kDlcToLen[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+static uint32_t len_to_dlc(uint8_t len)
+{
+    uint32_t dlc = 0;
+    while (dlc < 15U && kDlcToLen[dlc] < len) {
+        dlc++;
+    }
+    return dlc;
+}
+
+/* ---- Message RAM elements ---- */
+
+static uint32_t* rx_element(uint32_t index)
+{
+    return &s_msg_ram[MSG_RAM_RF0_WORDS + index * ELEMENT_WORDS];
+}
+
+static uint32_t* tx_element(uint32_t index)
+{
+    return &s_msg_ram[MSG_RAM_TB_WORDS + index * ELEMENT_WORDS];
+}
+
+/* Extended-ID CAN FD data frame with BRS; size must be a valid CAN FD length. */
+static void element_store(uint32_t* element, uint32_t can_id, uint8_t size, const uint8_t* data)
+{
+    element[0] = FDCAN_EXTENDED_ID | (can_id & ELEMENT_ID_MASK);
+    element[1] = FDCAN_FD_CAN | FDCAN_BRS_ON | (len_to_dlc(size) << ELEMENT_DLC_POS);
+    memset(&element[2], 0, HOST_FDCAN_MTU);
+    memcpy(&element[2], data, size);
+}
+
+static void element_load(const uint32_t* element, HostCanFrame* out)
+{
+    out->extended_can_id = element[0] & ELEMENT_ID_MASK;
+    out->size            = kDlcToLen[(element[1] >> ELEMENT_DLC_POS) & 0xFU];
+    memcpy(out->data, &element[2], out->size);
+}
+
+/* ---- Status registers ---- */
+
+static void update_rxf0s(void)
+{
+    const uint32_t put = (s_rx_get + s_rx_fill) % HOST_FDCAN_RX_FIFO_DEPTH;
+    host_fdcan1_regs.RXF0S = (s_rx_fill << FDCAN_RXF0S_F0FL_Pos) |
+                             (s_rx_get << FDCAN_RXF0S_F0GI_Pos) |
+                             (put << FDCAN_RXF0S_F0PI_Pos) |
+                             ((s_rx_fill == HOST_FDCAN_RX_FIFO_DEPTH) ? FDCAN_RXF0S_F0F : 0U);
+}
+
+/* Buffer the next request goes to: FIFO put index, or the lowest free buffer in queue mode. */
+static uint32_t tx_put_index(void)
+{
+    if (hfdcan1.Init.TxFifoQueueMode != FDCAN_TX_QUEUE_OPERATION) {
+        return s_tx_put;
+    }
+    uint32_t put = 0;
+    while (put < HOST_FDCAN_TX_FIFO_DEPTH && (host_fdcan1_regs.TXBRP & (1UL << put)) != 0U) {
+        put++;
+    }
+    return (put < HOST_FDCAN_TX_FIFO_DEPTH) ? put : 0U;
+}
+
+static void update_txfqs(void)
+{
+    const uint32_t pending = (uint32_t)__builtin_popcount(host_fdcan1_regs.TXBRP);
+    const uint32_t full    = (pending == HOST_FDCAN_TX_FIFO_DEPTH) ? FDCAN_TXFQS_TFQF : 0U;
+    /* TFFL / TFGI read as 0 in queue mode (RM0440) */
+    const uint32_t free_level = (hfdcan1.Init.TxFifoQueueMode == FDCAN_TX_QUEUE_OPERATION)
+                                    ? 0U : HOST_FDCAN_TX_FIFO_DEPTH - pending;
+    host_fdcan1_regs.TXFQS = (free_level << FDCAN_TXFQS_TFFL_Pos) |
+                             (tx_put_index() << FDCAN_TXFQS_TFQPI_Pos) | full;
+}
+
+/* RXF0A: releases every element from the get index up to and including index. */
+static void rx_acknowledge(uint32_t index)
+{
+    if (s_rx_fill == 0U || index >= HOST_FDCAN_RX_FIFO_DEPTH) {
+        return;
+    }
+    const uint32_t released = (index + HOST_FDCAN_RX_FIFO_DEPTH - s_rx_get) % HOST_FDCAN_RX_FIFO_DEPTH + 1U;
+    if (released > s_rx_fill) {
+        return;  /* not a filled element */
+    }
+    s_rx_get   = (index + 1U) % HOST_FDCAN_RX_FIFO_DEPTH;
+    s_rx_fill -= released;
+    update_rxf0s();
+}
+
+/* TXBAR: the elements of the requested buffers are already written. */
+static void tx_request(uint32_t buffers)
+{
+    for (uint32_t i = 0; i < HOST_FDCAN_TX_FIFO_DEPTH; i++) {
+        const uint32_t bit = 1UL << i;
+        if ((buffers & bit) == 0U || (host_fdcan1_regs.TXBRP & bit) != 0U) {
+            continue;
+        }
+        s_tx_seq_of[i] = s_tx_seq++;
+        host_fdcan1_regs.TXBRP |= bit;
+        if (hfdcan1.Init.TxFifoQueueMode != FDCAN_TX_QUEUE_OPERATION) {
+            s_tx_put = (i + 1U) % HOST_FDCAN_TX_FIFO_DEPTH;
+        }
+    }
+    update_txfqs();
+}
+
+void host_write_reg(volatile uint32_t* reg, uint32_t value)
+{
+    *reg = value;
+    if (reg == &host_fdcan1_regs.RXF0A) {
+        rx_acknowledge(value & (FDCAN_RXF0S_F0GI >> FDCAN_RXF0S_F0GI_Pos));
+    } else if (reg == &host_fdcan1_regs.TXBAR) {
+        tx_request(value);
+    }
+}
+
+/* Weak defaults, overridden by cyphal_transport.cpp as on the target. */
+__attribute__((weak)) void HAL_FDCAN_RxFifo0Callback(FDCAN_HandleTypeDef* hfdcan, uint32_t RxFifo0ITs)
+{
+    (void)hfdcan;
+    (void)RxFifo0ITs;
+}
+
+__attribute__((weak)) void HAL_FDCAN_TxBufferCompleteCallback(FDCAN_HandleTypeDef* hfdcan, uint32_t BufferIndexes)
+{
+    (void)hfdcan;
+    (void)BufferIndexes;
+}
+
+void MX_FDCAN1_Init(void)
+{
+    memset(&host_fdcan1_regs, 0, sizeof(host_fdcan1_regs));
+    memset(s_msg_ram, 0, sizeof(s_msg_ram));
+    memset(s_ext_filters, 0, sizeof(s_ext_filters));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_rx_get  = 0;
+    s_rx_fill = 0;
+    s_tx_put  = 0;
+    s_tx_seq  = 0;
+
+    hfdcan1.Instance                = FDCAN1;
+    hfdcan1.Init.FrameFormat        = FDCAN_FRAME_FD_BRS;
+    hfdcan1.Init.Mode               = FDCAN_MODE_NORMAL;
+    hfdcan1.Init.AutoRetransmission = DISABLE;
+    hfdcan1.Init.StdFiltersNbr      = 0;
+    hfdcan1.Init.ExtFiltersNbr      = EXT_FILTERS_MAX;
+    hfdcan1.Init.TxFifoQueueMode    = FDCAN_TX_QUEUE_OPERATION;
+    hfdcan1.State                   = HAL_FDCAN_STATE_READY;
+    hfdcan1.ErrorCode               = 0;
+
+    hfdcan1.msgRam.StandardFilterSA = (uintptr_t)&s_msg_ram[MSG_RAM_FLS_WORDS];
+    hfdcan1.msgRam.ExtendedFilterSA = (uintptr_t)&s_msg_ram[MSG_RAM_FLE_WORDS];
+    hfdcan1.msgRam.RxFIFO0SA        = (uintptr_t)&s_msg_ram[MSG_RAM_RF0_WORDS];
+    hfdcan1.msgRam.RxFIFO1SA        = (uintptr_t)&s_msg_ram[MSG_RAM_RF1_WORDS];
+    hfdcan1.msgRam.TxEventFIFOSA    = (uintptr_t)&s_msg_ram[MSG_RAM_EF_WORDS];
+    hfdcan1.msgRam.TxFIFOQSA        = (uintptr_t)&s_msg_ram[MSG_RAM_TB_WORDS];
+
+    update_rxf0s();
+    update_txfqs();
+
+    /* As in Core/Src/fdcan.c: accept all extended IDs until the filters are programmed */
+    if (HAL_FDCAN_ConfigGlobalFilter(&hfdcan1, FDCAN_REJECT, FDCAN_ACCEPT_IN_RX_FIFO0,
+                                     FDCAN_REJECT_REMOTE, FDCAN_REJECT_REMOTE) != HAL_OK) {
+        Error_Handler();
+    }
+}
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigFilter(FDCAN_HandleTypeDef* hfdcan, const FDCAN_FilterTypeDef* sFilterConfig)
+{
+    if (hfdcan->State != HAL_FDCAN_STATE_READY && hfdcan->State != HAL_FDCAN_STATE_BUSY) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_NOT_READY;
+        return HAL_ERROR;
+    }
+    if (sFilterConfig->IdType != FDCAN_EXTENDED_ID) {
+        return HAL_OK;  /* StdFiltersNbr = 0: standard elements are never evaluated */
+    }
+    if (sFilterConfig->FilterIndex >= hfdcan->Init.ExtFiltersNbr) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_PARAM;
+        return HAL_ERROR;
+    }
+    ExtFilter* const f = &s_ext_filters[sFilterConfig->FilterIndex];
+    f->config = sFilterConfig->FilterConfig;
+    f->type   = sFilterConfig->FilterType;
+    f->id1    = sFilterConfig->FilterID1;
+    f->id2    = sFilterConfig->FilterID2;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_ConfigGlobalFilter(FDCAN_HandleTypeDef* hfdcan, uint32_t NonMatchingStd,
+                                               uint32_t NonMatchingExt, uint32_t RejectRemoteStd,
+                                               uint32_t RejectRemoteExt)
+{
+    (void)NonMatchingStd;
+    (void)RejectRemoteStd;
+    (void)RejectRemoteExt;
+    if (hfdcan->State != HAL_FDCAN_STATE_READY) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_NOT_READY;
+        return HAL_ERROR;
+    }
+    s_non_matching_ext = NonMatchingExt;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_ActivateNotification(FDCAN_HandleTypeDef* hfdcan, uint32_t ActiveITs,
+                                                 uint32_t BufferIndexes)
+{
+    if (hfdcan->State != HAL_FDCAN_STATE_READY && hfdcan->State != HAL_FDCAN_STATE_BUSY) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_NOT_READY;
+        return HAL_ERROR;
+    }
+    if ((ActiveITs & FDCAN_IT_TX_COMPLETE) != 0U) {
+        hfdcan->Instance->TXBTIE |= BufferIndexes;
+    }
+    hfdcan->Instance->IE |= ActiveITs;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_Start(FDCAN_HandleTypeDef* hfdcan)
+{
+    if (hfdcan->State != HAL_FDCAN_STATE_READY) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_NOT_READY;
+        return HAL_ERROR;
+    }
+    hfdcan->State = HAL_FDCAN_STATE_BUSY;
+    update_rxf0s();
+    update_txfqs();  /* TxFifoQueueMode may have changed since MX_FDCAN1_Init() */
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_AddMessageToTxFifoQ(FDCAN_HandleTypeDef* hfdcan,
+                                                const FDCAN_TxHeaderTypeDef* pTxHeader,
+                                                const uint8_t* pTxData)
+{
+    if (hfdcan->State != HAL_FDCAN_STATE_BUSY) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_NOT_STARTED;
+        return HAL_ERROR;
+    }
+    if ((hfdcan->Instance->TXFQS & FDCAN_TXFQS_TFQF) != 0U) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_FIFO_FULL;
+        return HAL_ERROR;
+    }
+    const uint32_t put = (hfdcan->Instance->TXFQS & FDCAN_TXFQS_TFQPI) >> FDCAN_TXFQS_TFQPI_Pos;
+    element_store(tx_element(put), pTxHeader->Identifier,
+                  kDlcToLen[pTxHeader->DataLength & 0xFU], pTxData);
+    WRITE_REG(hfdcan->Instance->TXBAR, 1UL << put);
+    hfdcan->LatestTxFifoQRequest = 1UL << put;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FDCAN_GetRxMessage(FDCAN_HandleTypeDef* hfdcan, uint32_t RxLocation,
+                                         FDCAN_RxHeaderTypeDef* pRxHeader, uint8_t* pRxData)
+{
+    if (RxLocation != FDCAN_RX_FIFO0) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_PARAM;
+        return HAL_ERROR;
+    }
+    if (s_rx_fill == 0U) {
+        hfdcan->ErrorCode |= FDCAN_ERROR_FIFO_EMPTY;
+        return HAL_ERROR;
+    }
+    const uint32_t get = s_rx_get;
+    HostCanFrame f;
+    element_load(rx_element(get), &f);
+    memset(pRxHeader, 0, sizeof(*pRxHeader));
+    pRxHeader->Identifier    = f.extended_can_id;
+    pRxHeader->IdType        = FDCAN_EXTENDED_ID;
+    pRxHeader->RxFrameType   = FDCAN_DATA_FRAME;
+    pRxHeader->DataLength    = len_to_dlc(f.size);
+    pRxHeader->BitRateSwitch = FDCAN_BRS_ON;
+    pRxHeader->FDFormat      = FDCAN_FD_CAN;
+    memcpy(pRxData, f.data, f.size);
+    WRITE_REG(hfdcan->Instance->RXF0A, get);
+    return HAL_OK;
+}
+
+/* TXFQS.TFFL, as in the G4 HAL: always 0 in queue mode */
+uint32_t HAL_FDCAN_GetTxFifoFreeLevel(const FDCAN_HandleTypeDef* hfdcan)
+{
+    return (hfdcan->Instance->TXFQS & FDCAN_TXFQS_TFFL) >> FDCAN_TXFQS_TFFL_Pos;
+}
+
+uint32_t HAL_FDCAN_GetLatestTxFifoQRequestBuffer(const FDCAN_HandleTypeDef* hfdcan)
+{
+    return hfdcan->LatestTxFifoQRequest;
+}
+
+uint32_t HAL_FDCAN_IsTxBufferMessagePending(const FDCAN_HandleTypeDef* hfdcan, uint32_t TxBufferIndex)
+{
+    return ((hfdcan->Instance->TXBRP & TxBufferIndex) != 0U) ? 1U : 0U;
+}
+
+/* ----------------------------------------------------------------------- */
+/* Bus side                                                                 */
+/* ----------------------------------------------------------------------- */
+
+static bool ext_filter_matches(const ExtFilter* f, uint32_t id)
+{
+    switch (f->type) {
+    case FDCAN_FILTER_MASK:  return (id & f->id2) == (f->id1 & f->id2);
+    case FDCAN_FILTER_DUAL:  return id == f->id1 || id == f->id2;
+    case FDCAN_FILTER_RANGE: return id >= f->id1 && id <= f->id2;
+    default:                 return false;
+    }
+}
+
+static bool rx_accepted(uint32_t id)
+{
+    for (uint32_t i = 0; i < hfdcan1.Init.ExtFiltersNbr; i++) {
+        const ExtFilter* f = &s_ext_filters[i];
+        if (f->config == FDCAN_FILTER_DISABLE || !ext_filter_matches(f, id)) {
+            continue;
+        }
+        return f->config == FDCAN_FILTER_TO_RXFIFO0;
+    }
+    return s_non_matching_ext == FDCAN_ACCEPT_IN_RX_FIFO0;
+}
+
+bool host_fdcan_receive(const HostCanFrame* frame)
+{
+    if (hfdcan1.State != HAL_FDCAN_STATE_BUSY || !rx_accepted(frame->extended_can_id)) {
+        s_stats.rx_filtered++;
+        return false;
+    }
+    if (s_rx_fill >= HOST_FDCAN_RX_FIFO_DEPTH) {
+        s_stats.rx_lost++;
+        return false;
+    }
+    uint8_t data[HOST_FDCAN_MTU] = { 0 };
+    const uint8_t size = kDlcToLen[len_to_dlc(frame->size)];
+    memcpy(data, frame->data, (frame->size < size) ? frame->size : size);
+    element_store(rx_element((s_rx_get + s_rx_fill) % HOST_FDCAN_RX_FIFO_DEPTH),
+                  frame->extended_can_id, size, data);
+    s_rx_fill++;
+    update_rxf0s();
+    s_stats.rx_accepted++;
+
+    hfdcan1.Instance->IR |= FDCAN_IR_RF0N;
+    const uint32_t its = hfdcan1.Instance->IR & hfdcan1.Instance->IE & FDCAN_IE_RF0NE;
+    if (its != 0U) {
+        hfdcan1.Instance->IR &= ~its;
+        HAL_FDCAN_RxFifo0Callback(&hfdcan1, its);
+    }
+    return true;
+}
+
+/* Index of the pending buffer that wins arbitration next. */
+static uint32_t tx_next_buffer(uint32_t pending)
+{
+    const bool queue = hfdcan1.Init.TxFifoQueueMode == FDCAN_TX_QUEUE_OPERATION;
+    uint32_t next = HOST_FDCAN_TX_FIFO_DEPTH;
+    for (uint32_t i = 0; i < HOST_FDCAN_TX_FIFO_DEPTH; i++) {
+        if ((pending & (1UL << i)) == 0U) {
+            continue;
+        }
+        if (next == HOST_FDCAN_TX_FIFO_DEPTH) {
+            next = i;
+        } else if (queue) {
+            if ((tx_element(i)[0] & ELEMENT_ID_MASK) < (tx_element(next)[0] & ELEMENT_ID_MASK)) {
+                next = i;
+            }
+        } else if ((int32_t)(s_tx_seq_of[i] - s_tx_seq_of[next]) < 0) {
+            next = i;
+        }
+    }
+    return next;
+}
+
+bool host_fdcan_transmit(HostCanFrame* out)
+{
+    const uint32_t pending = hfdcan1.Instance->TXBRP;
+    if (pending == 0U) {
+        return false;
+    }
+    const uint32_t next = tx_next_buffer(pending);
+    HostCanFrame frame;
+    element_load(tx_element(next), &frame);
+    for (uint32_t i = 0; i < HOST_FDCAN_TX_FIFO_DEPTH; i++) {
+        if ((pending & (1UL << i)) != 0U &&
+            (tx_element(i)[0] & ELEMENT_ID_MASK) == frame.extended_can_id &&
+            (int32_t)(s_tx_seq_of[i] - s_tx_seq_of[next]) < 0) {
+            s_stats.tx_reordered++;
+            break;
+        }
+    }
+    if (out != NULL) {
+        *out = frame;
+    }
+    const uint32_t buffer = 1UL << next;
+    hfdcan1.Instance->TXBRP &= ~buffer;
+    update_txfqs();
+    s_stats.tx_sent++;
+
+    hfdcan1.Instance->IR |= FDCAN_IR_TC;
+    if ((hfdcan1.Instance->IE & FDCAN_IE_TCE) != 0U) {
+        const uint32_t buffers = buffer & hfdcan1.Instance->TXBTIE;
+        hfdcan1.Instance->IR &= ~FDCAN_IR_TC;
+        if (buffers != 0U) {
+            HAL_FDCAN_TxBufferCompleteCallback(&hfdcan1, buffers);
+        }
+    }
+    return true;
+}
+
+size_t host_fdcan_tx_pending(void)
+{
+    return (size_t)__builtin_popcount(hfdcan1.Instance->TXBRP);
+}
+
+void host_fdcan_get_stats(HostFdcanStats* out)
+{
+    if (out != NULL) {
+        *out = s_stats;
+    }
+}
@@ -0,0 +1,88 @@
+/**
+ * @file hal_tim_host.c
+ * @brief Host shims for TIM / GPIO / DWT / Error_Handler. Registers are plain memory.
+ */
+
+#include "main.h"
+#include "tim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+TIM_TypeDef host_tim1;
+TIM_TypeDef host_tim2;
+TIM_TypeDef host_tim17;
+
+TIM_HandleTypeDef htim1  = { .Instance = TIM1 };
+TIM_HandleTypeDef htim2  = { .Instance = TIM2 };
+TIM_HandleTypeDef htim17 = { .Instance = TIM17 };
+
+GPIO_TypeDef host_gpioa;
+GPIO_TypeDef host_gpiob;
+GPIO_TypeDef host_gpiof;
+
+CoreDebug_Type  host_core_debug;
+static DWT_Type s_dwt;
+
+/* Same periods as Core/Src/tim.c */
+void MX_TIM1_Init(void)
+{
+    host_tim1.PSC = 7;
+    host_tim1.ARR = 999;
+}
+
+void MX_TIM2_Init(void)
+{
+    host_tim2.PSC = 159;
+    host_tim2.ARR = 19999;
+}
+
+void MX_TIM17_Init(void)
+{
+    host_tim17.PSC = 159;
+    host_tim17.ARR = 65535;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef* htim, uint32_t Channel)
+{
+    (void)Channel;
+    htim->Instance->CR1 |= 1U;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim)
+{
+    htim->Instance->DIER |= TIM_IT_UPDATE;
+    htim->Instance->CR1  |= 1U;
+    return HAL_OK;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->ODR ^= GPIO_Pin;
+}
+
+DWT_Type* host_dwt(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if ((s_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U) {
+        s_dwt.CYCCNT = (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+    }
+    return &s_dwt;
+}
+
+void Error_Handler(void)
+{
+    fprintf(stderr, "Error_Handler\n");
+    abort();
+}
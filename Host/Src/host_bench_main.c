@@ -0,0 +1,100 @@
+/**
+ * @file host_bench_main.c
+ * @brief usagi_bench: runs CyphalBenchTask on the host and prints one JSON line per scenario.
+ *
+ *   usagi_bench [candump.log]
+ *
+ * The optional log (candump -l / -L format, e.g. "(1700000000.000000) vcan0 0C4B6E2A##1DEADBEEF")
+ * is replayed as the rx_replay scenario. Only extended-ID data frames are used.
+ */
+
+#include "cyphal_bench.h"
+#include "cyphal_node.h"
+#include "fdcan.h"
+#include "main.h"
+#include "mono_clock.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int hex_nibble(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    c = (char)tolower((unsigned char)c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* Parses the "<id>#<data>" or "<id>##<flags><data>" token of one candump line. */
+static bool parse_candump_line(const char* line, CyphalBenchFrame* out)
+{
+    const char* hash = strchr(line, '#');
+    if (hash == NULL) return false;
+    const char* id_begin = hash;
+    while (id_begin > line && isxdigit((unsigned char)id_begin[-1])) id_begin--;
+    if (hash - id_begin != 8) return false;  /* 29-bit IDs are printed with 8 digits */
+
+    out->can_id = (uint32_t)strtoul(id_begin, NULL, 16) & 0x1FFFFFFFUL;
+    const char* p = hash + 1;
+    if (*p == '#') {
+        p += 2;                                /* FD frame: skip the flags nibble */
+    } else if (*p == 'R') {
+        return false;                          /* remote frame */
+    }
+    out->size = 0;
+    while (out->size < sizeof(out->data)) {
+        const int hi = hex_nibble(p[0]);
+        const int lo = (hi >= 0) ? hex_nibble(p[1]) : -1;
+        if (lo < 0) break;
+        out->data[out->size++] = (uint8_t)((hi << 4) | lo);
+        p += 2;
+    }
+    return out->size > 0;
+}
+
+static bool load_candump(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    size_t cap = 1024;
+    size_t count = 0;
+    CyphalBenchFrame* frames = malloc(cap * sizeof(*frames));
+    char line[256];
+    while (frames != NULL && fgets(line, sizeof(line), f) != NULL) {
+        if (count == cap) {
+            cap *= 2;
+            CyphalBenchFrame* grown = realloc(frames, cap * sizeof(*frames));
+            if (grown == NULL) break;
+            frames = grown;
+        }
+        if (parse_candump_line(line, &frames[count])) count++;
+    }
+    fclose(f);
+    if (frames == NULL) return false;
+    cyphal_bench_set_recording(frames, count);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && !load_candump(argv[1])) {
+        return 1;
+    }
+
+    MX_FDCAN1_Init();
+    mono_clock_init();
+    if (!cyphal_node_init()) {
+        Error_Handler();
+    }
+
+    xTaskCreate(CyphalBenchTask, "CyphalBench", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL);
+    vTaskStartScheduler();
+    return 0;
+}
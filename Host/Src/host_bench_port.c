@@ -0,0 +1,59 @@
+/**
+ * @file host_bench_port.c
+ * @brief Host side of cyphal_bench.h: DWT shim in ns, simulated FDCAN drained on demand.
+ */
+
+#include "cyphal_bench.h"
+#include "host_fdcan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* cyphal_bench_platform(void)
+{
+    return "host";
+}
+
+uint32_t cyphal_bench_cycles_per_sec(void)
+{
+    return 1000000000UL;  /* host_dwt(): 1 count = 1 ns */
+}
+
+void cyphal_bench_prepare_bus(void)
+{
+}
+
+bool cyphal_bench_service_tx(void)
+{
+    while (host_fdcan_transmit(NULL)) {
+    }
+    return true;
+}
+
+bool cyphal_bench_bus_transmit(CyphalBenchFrame* out)
+{
+    HostCanFrame frame;
+    if (!host_fdcan_transmit(&frame)) {
+        return false;
+    }
+    out->can_id = frame.extended_can_id;
+    out->size   = frame.size;
+    memcpy(out->data, frame.data, frame.size);
+    return true;
+}
+
+bool cyphal_bench_bus_receive(const CyphalBenchFrame* frame)
+{
+    HostCanFrame f;
+    f.extended_can_id = frame->can_id;
+    f.size            = frame->size;
+    memcpy(f.data, frame->data, frame->size);
+    return host_fdcan_receive(&f);
+}
+
+void cyphal_bench_finish(void)
+{
+    printf("{\"bench\":\"done\",\"platform\":\"%s\"}\n", cyphal_bench_platform());
+    fflush(stdout);
+    exit(0);
+}
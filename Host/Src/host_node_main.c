@@ -0,0 +1,61 @@
+/**
+ * @file host_node_main.c
+ * @brief usagi_host_node: the firmware's Cyphal node on Linux, bus = SocketCAN (default vcan0).
+ *
+ * Same start-up sequence and task priorities as Core/Src/main.c, with the SocketCAN bridge
+ * task in place of the LED task. The TIM2 update interrupt is stood in for by a task that
+ * calls actuator_loop_isr_period() every servo PWM period.
+ *
+ *   usagi_host_node [ifname]
+ */
+
+#include "actuator_command.h"
+#include "actuator_loop.h"
+#include "cyphal_node.h"
+#include "fdcan.h"
+#include "host_socketcan.h"
+#include "main.h"
+#include "mono_clock.h"
+#include "tim.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdio.h>
+
+/* TIM2 update event: highest priority, like the interrupt it replaces */
+static void HostTim2Task(void* pvParameters)
+{
+    (void)pvParameters;
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(ACTUATOR_LOOP_PERIOD_USEC / 1000U));
+        actuator_loop_isr_period();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* ifname = (argc > 1) ? argv[1] : "vcan0";
+
+    MX_FDCAN1_Init();
+    MX_TIM1_Init();
+    MX_TIM2_Init();
+    MX_TIM17_Init();
+    mono_clock_init();
+    if (!cyphal_node_init()) {
+        Error_Handler();
+    }
+    actuator_command_init();
+
+    if (!host_socketcan_open(ifname)) {
+        return 1;
+    }
+    printf("usagi_host_node on %s\n", ifname);
+
+    xTaskCreate(HostSocketCanTask, "SocketCAN", configMINIMAL_STACK_SIZE * 1, NULL, 1, NULL);
+    xTaskCreate(CyphalControlTask, "CyphalCtrl", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL);
+    xTaskCreate(ActuatorTask, "Actuator", configMINIMAL_STACK_SIZE * 2, NULL, 3, NULL);
+    xTaskCreate(HostTim2Task, "HostTim2", configMINIMAL_STACK_SIZE * 1, NULL, configMAX_PRIORITIES - 1, NULL);
+    vTaskStartScheduler();
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file host_socketcan.c
+ * @brief SocketCAN FD bridge for the simulated FDCAN1.
+ */
+
+#include "host_socketcan.h"
+#include "host_fdcan.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <errno.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define POLL_TIMEOUT_MS  1   /* idle wake-up period of the bridge task */
+
+static int s_fd = -1;
+
+/*
+ * host_fdcan_receive() / host_fdcan_transmit() raise the RX FIFO0 / TX-complete "interrupts"
+ * (isr_rx, isr_tx_complete) on the calling thread. This task has the lowest priority, so
+ * without the scheduler lock CyphalCtrl or Actuator could preempt it in the middle of one and
+ * race the controller registers (TXBRP, IR/IE) against flush_tx(). A real ISR is atomic with
+ * respect to every task; suspending the scheduler around each call gives the same guarantee.
+ */
+static bool raise_rx(const HostCanFrame* frame)
+{
+    vTaskSuspendAll();
+    const bool stored = host_fdcan_receive(frame);
+    (void)xTaskResumeAll();
+    return stored;
+}
+
+static bool raise_tx(HostCanFrame* out)
+{
+    vTaskSuspendAll();
+    const bool sent = host_fdcan_transmit(out);
+    (void)xTaskResumeAll();
+    return sent;
+}
+
+bool host_socketcan_open(const char* ifname)
+{
+    const int fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK, CAN_RAW);
+    if (fd < 0) {
+        perror("socket(PF_CAN)");
+        return false;
+    }
+    const int on = 1;
+    if (setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &on, sizeof(on)) != 0) {
+        perror("CAN_RAW_FD_FRAMES");
+        close(fd);
+        return false;
+    }
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family  = AF_CAN;
+    addr.can_ifindex = (int)if_nametoindex(ifname);
+    if (addr.can_ifindex == 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "cannot bind to %s: %s\n", ifname, strerror(errno));
+        close(fd);
+        return false;
+    }
+    s_fd = fd;
+    return true;
+}
+
+/* Socket → controller. Only extended data frames reach the controller (Cyphal/CAN). */
+static void drain_socket(void)
+{
+    struct canfd_frame cf;
+    for (;;) {
+        const ssize_t n = read(s_fd, &cf, sizeof(cf));
+        if (n != (ssize_t)CANFD_MTU && n != (ssize_t)CAN_MTU) {
+            break;
+        }
+        if ((cf.can_id & CAN_EFF_FLAG) == 0U || (cf.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG)) != 0U) {
+            continue;
+        }
+        HostCanFrame f;
+        f.extended_can_id = cf.can_id & CAN_EFF_MASK;
+        f.size            = (cf.len <= HOST_FDCAN_MTU) ? cf.len : HOST_FDCAN_MTU;
+        memcpy(f.data, cf.data, f.size);
+        (void)raise_rx(&f);
+    }
+}
+
+/* Controller → socket. Frames stay in the TX FIFO while the socket is backpressured. */
+static void drain_controller(void)
+{
+    while (host_fdcan_tx_pending() > 0U) {
+        struct pollfd pfd = { .fd = s_fd, .events = POLLOUT, .revents = 0 };
+        if (poll(&pfd, 1, 0) <= 0 || (pfd.revents & POLLOUT) == 0) {
+            break;
+        }
+        HostCanFrame f;
+        if (!raise_tx(&f)) {
+            break;
+        }
+        struct canfd_frame cf;
+        memset(&cf, 0, sizeof(cf));
+        cf.can_id = (f.extended_can_id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+        cf.len    = f.size;
+        cf.flags  = CANFD_BRS;
+        memcpy(cf.data, f.data, f.size);
+        if (write(s_fd, &cf, CANFD_MTU) != (ssize_t)CANFD_MTU) {
+            perror("write(CAN)");
+        }
+    }
+}
+
+void HostSocketCanTask(void* pvParameters)
+{
+    (void)pvParameters;
+    for (;;) {
+        /* Blocking here is preempted by the tick like any other host code in a task. */
+        const short events = (short)(POLLIN | ((host_fdcan_tx_pending() > 0U) ? POLLOUT : 0));
+        struct pollfd pfd = { .fd = s_fd, .events = events, .revents = 0 };
+        (void)poll(&pfd, 1, POLL_TIMEOUT_MS);
+        drain_socket();
+        drain_controller();
+    }
+}
@@ -0,0 +1,30 @@
+/**
+ * @file mono_clock_host.c
+ * @brief Host implementation of mono_clock.h on CLOCK_MONOTONIC (µs since mono_clock_init).
+ */
+
+#include "mono_clock.h"
+#include <time.h>
+
+static uint64_t s_origin_usec;
+
+static uint64_t now_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000ULL);
+}
+
+void mono_clock_init(void)
+{
+    s_origin_usec = now_usec();
+}
+
+void mono_clock_isr_overflow(void)
+{
+}
+
+uint64_t mono_clock_usec(void)
+{
+    return now_usec() - s_origin_usec;
+}